@@ -1,14 +1,15 @@
 #include "game.h"
+#include "sim.h"
 #include "raylib.h"
 #include "rlgl.h"
 
+#include "util/profiler.h"
 #include "util/vec_ops.h"
 #include "raymath.h"
 #include <cmath>
 #include <cstdint>
 #include <limits>
 #include <algorithm>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -20,22 +21,6 @@
 #define DLL_EXPORT
 #endif
 
-bool checkBounds(const GameState& gs, const ThingPos& pos) {
-    return (pos.row >= 0 && pos.row < BOARD_HEIGHT && pos.col >= 0 && pos.col < (((pos.row + gs.board.even) % 2) ? (BOARD_WIDTH - 1) : (BOARD_WIDTH)));
-}
-
-Tile& getTile(GameState& gs, const ThingPos& pos) {
-    return gs.board.things[pos.row][pos.col];
-}
-
-std::vector<ThingPos> getNeighs(GameState& gs, const ThingPos& pos) {
-    std::vector<ThingPos> res;
-    for (int i = 0; i < 6; ++i)
-        if (checkBounds(gs, TOGO[i]))
-            res.push_back(TOGO[i]);
-    return res;
-}
-
 std::string replace(std::string& str, const std::string& from, const std::string& to) {
     size_t start_pos = str.find(from);
     str.replace(start_pos, from.length(), to);
@@ -49,121 +34,51 @@ std::string prepShader(unsigned char* shaderBytes) {
 
 extern "C" {
 
-int getRandVal(GameState& gs, int min, int max) {
-    SetRandomSeed(gs.seed++);
-    return GetRandomValue(min, max);
-}
-
-double getTime(const GameState& gs) {
-    return (GetTime() + gs.tmp.timeOffset);// * 0.5f;
-}
-
-float getFrameTime(const GameState& gs) {
-    return GetFrameTime();// * 0.5f;
-}
-
 void playSound(const GameState& gs, const Sound& snd) {
     if (gs.usr.sndEnabled)
         PlaySound(snd);
 }
 
-float easeOutBounce(float x)
-{
-    float n1 = 7.5625f;
-    float d1 = 2.75f;
-
-    if (x < 1 / d1) {
-        return n1 * x * x;
-    } else if (x < 2 / d1) {
-        return n1 * (x - 1.5 / d1) * (x - 1.5 / d1) + 0.75;
-    } else if (x < 2.5 / d1) {
-        return n1 * (x - 2.25 / d1) * (x - 2.25 / d1) + 0.9375;
-    } else {
-        return n1 * (x - 2.625 / d1) * (x - 2.625 / d1) + 0.984375;
-    }
-}
-
-float easeOutQuad(float t) {
-    return 1 - (1 - t) * (1 - t);
-}
-
-float easeInQuad(float t) {
-    return t * t;
-}
-
-Rectangle getBoardRect(const GameState& gs) {
-    float bWidth = TILE_RADIUS * 2 * BOARD_WIDTH;
-    float bHeight = ROW_HEIGHT * BOARD_HEIGHT;
-    float startCoeff = easeOutQuad(std::clamp((getTime(gs) - gs.gameStartTime)/GAME_START_TIME, 0.0, 1.0));
-    Vector2 bPos = {(GetScreenWidth() - bWidth) * 0.5f, (float)GetScreenHeight() - 2 * bHeight + bHeight * startCoeff + gs.board.pos};
-    return {float(int(bPos.x)), float(int(bPos.y)), bWidth, bHeight};
-}
-
-ThingPos getPosByPix(const GameState& gs, const Vector2& pix) {
-    auto brec = getBoardRect(gs);
-    int row = std::clamp((int)floor((pix.y - brec.y) / ROW_HEIGHT), 0, BOARD_HEIGHT - 1);
-    bool shortRow = ((row + gs.board.even) % 2);
-    int col = std::clamp((int)floor((pix.x - brec.x - float(shortRow) * TILE_RADIUS) / (TILE_RADIUS * 2)), 0, shortRow ? (BOARD_WIDTH - 2) : (BOARD_WIDTH - 1));
-    return {row, col};
-}
-
-Vector2 getPixByPos(const GameState& gs, const ThingPos& pos) {
-    auto brec = getBoardRect(gs);
-    float offset = float((pos.row + gs.board.even) % 2) * TILE_RADIUS;
-    return {float(int(offset + brec.x + TILE_RADIUS + pos.col * TILE_RADIUS * 2)), (float)int(brec.y + (pos.row + 0.5f) * ROW_HEIGHT)};
-}
-
-int countBotEmpRows(const GameState& gs) {
-    int n = 0;
-    bool keep = true;
-    for (int row = BOARD_HEIGHT - 1; row >= 0; --row) {
-        for (int col = 0; col < BOARD_WIDTH - ((row + gs.board.even) % 2); ++col) {
-            if (gs.board.things[row][col].exists) {
-                keep = false;
-                break;
-            }
+const QualityTier& qualityTier(const GameState& gs) {
+    return QUALITY_TIERS[gs.tmp.quality.tier];
+}
+
+// Steps the quality tier one at a time: down once the smoothed frame time is over budget
+// (at most every QUALITY_STEP_COOLDOWN), back up after QUALITY_RESTORE_TIME with headroom
+void updateQuality(GameState& gs) {
+    auto& q = gs.tmp.quality;
+    float dt = GetFrameTime();
+    float budget = 1.0f / gs.tmp.targetFps;  // still the target the last frame ran at
+    // A single stall (a resume, a resize) shouldn't swing it all the way
+    q.load += (std::min(dt / budget, 3.0f) - q.load) * QUALITY_SMOOTHING;
+    q.stepCooldown = std::max(q.stepCooldown - dt, 0.0f);
+    if (q.load > QUALITY_OVERLOAD) {
+        q.calmTime = 0;
+        if (q.stepCooldown == 0 && q.tier + 1 < (int)std::size(QUALITY_TIERS)) {
+            q.tier++;
+            q.stepCooldown = QUALITY_STEP_COOLDOWN;
         }
-        if (!keep) break;
-        n++;
-    }
-    return n;
-}
-
-bool checkFullRow(const GameState& gs, int row) {
-    bool fullrow = true;
-    for (int i = 0; i < BOARD_WIDTH - ((row + gs.board.even) % 2); ++i) {
-        if (!gs.board.things[row][i].exists) {
-            fullrow = false;
-            break;
+    } else if (q.load < QUALITY_HEADROOM) {
+        q.calmTime += dt;
+        if (q.calmTime > QUALITY_RESTORE_TIME && q.tier > 0) {
+            q.tier--;
+            q.calmTime = 0;
         }
-    }
-    return fullrow;
-}
-
-void addTile(GameState& gs, const ThingPos& pos, const Tile& tile, bool updateFullRows = true, bool makeExist = false) {
-    auto& th = gs.board.things[pos.row][pos.col];
-    th = tile;
-    if (makeExist) th.exists = true;
-    th.pos = pos;
-
-    if (updateFullRows) {
-        int i = 0;
-        while ((pos.row - i > 0) && checkFullRow(gs, pos.row - i)) i++;
-        if (i > 0 && pos.row - i <= gs.board.nFulRowsTop)
-            gs.board.nFulRowsTop = pos.row + 1;
+    } else {
+        q.calmTime = 0;
     }
 }
 
-void addShatteredParticles(GameState& gs, const Thing& thing, Vector2 pos) {
-    uint8_t mskId1 = getRandVal(gs, 0, 2);
-    for (uint8_t mskId2 = 0; mskId2 < 5; ++mskId2) {
+void addShatteredParticles(GameState& gs, const Thing& thing, Vector2 pos, uint8_t mskId1) {
+    for (uint8_t mskId2 = 0; mskId2 < qualityTier(gs).shatterShards; ++mskId2) {
         Vector2 vel;
         if (mskId2 == 0) vel = {0, -1};
         else if (mskId2 == 1) vel = {-cos(PI*0.25f), -cos(PI*0.25f)};
         else if (mskId2 == 2) vel = {1, 0};
         else if (mskId2 == 3) vel = {0, 1};
         else if (mskId2 == 4) vel = {-cos(PI*0.25f), cos(PI*0.25f)};
-        gs.tmp.particles.acquire(Particle{true, thing, pos, 200.0f * vel + Vector2{200 * RAND_FLOAT_SIGNED, -200 - 200 * RAND_FLOAT}, false, true, {6, 0}, mskId1, mskId2});
+        vel = 200.0f * vel + Vector2{200 * RAND_FLOAT_SIGNED, -200 - 200 * RAND_FLOAT};
+        gs.tmp.particles.spawn(pos.x, pos.y, vel.x, vel.y, ParticleLook{thing, true, {6, 0}, mskId1, mskId2});
     }
 }
 
@@ -171,91 +86,19 @@ void addAnimation(GameState& gs, const Texture2D* tex, float interval, Vector2 p
     gs.tmp.animations.acquire(Animation{tex, getTime(gs), interval, pos, col});
 }
 
-void addScorePoints(GameState& gs, Vector2 pos, Color col, int n) {
+// n points of score, merged into fewer flying points on lower quality tiers
+void spawnScorePoints(GameState& gs, Vector2 pos, Color col, int n) {
     auto brec = getBoardRect(gs);
-    for (int i = 0; i < n; ++i) {
+    int perPoint = qualityTier(gs).scorePerPoint;
+    for (int i = 0; i < n; i += perPoint) {
         Vector2 endPos = {TILE_RADIUS * 2.0f + brec.x - TILE_RADIUS * 0.5f + (brec.width - TILE_RADIUS * 6.0f) * 0.25f, GetScreenHeight() - TILE_RADIUS};
         Vector2 cpPos = {brec.x + brec.width * 0.5f + RAND_FLOAT_SIGNED * brec.width * 0.33f, 0.5f * (endPos.y + pos.y) };
-        gs.tmp.scorePoints.acquire(ScorePoint{pos + TILE_RADIUS * RAND_FLOAT_SIGNED_2D, cpPos, endPos, getTime(gs), SCORE_FLY_TIME + RAND_FLOAT * SCORE_FLY_SPREAD, col});
+        gs.tmp.scorePoints.acquire(ScorePoint{pos + TILE_RADIUS * RAND_FLOAT_SIGNED_2D, cpPos, endPos, getTime(gs), SCORE_FLY_TIME + RAND_FLOAT * SCORE_FLY_SPREAD, col, false, std::min(perPoint, n - i)});
     }
-    gs.score += n;
 }
 
 void addParticle(GameState& gs, const Thing& thing, Vector2 pos, Vector2 vel) {
-    gs.tmp.particles.acquire(Particle{true, thing, pos, vel});
-}
-
-void generateRows(GameState& gs, int n) {
-    for (int row = 0; row < n; ++row) {
-        for (int col = 0; col < BOARD_WIDTH - ((row + gs.board.even) % 2); ++col) {
-            addTile(gs, {row, col}, Tile{(col != (BOARD_WIDTH - 1)) || ((row + gs.board.even) % 2 == 0), {row, col}, {(unsigned char)getRandVal(gs, 0, COLORS.size() - 1), (unsigned char)getRandVal(gs, 0, COLORS.size() - 1), (unsigned char)getRandVal(gs, 0, COLORS.size() - 1)}});
-            auto& thing = gs.board.things[row][col].thing;
-            thing.bomb = (getRandVal(gs, 0, 100000) < 100000 * BOMB_PROB);
-            thing.triggered = false;
-        }
-    }
-}
-
-void removeTile(GameState& gs, const ThingPos& pos) {
-    gs.board.things[pos.row][pos.col].exists = false;
-    gs.board.things[pos.row][pos.col].pos = pos;
-    if (pos.row < gs.board.nFulRowsTop)
-        gs.board.nFulRowsTop = pos.row + 1;
-}
-
-void shiftBoard(GameState& gs, int off) {
-    if (off % 2 != 0)
-        gs.board.even = !gs.board.even;
-    if (off < 0) {
-        for (int row = 0; row < BOARD_HEIGHT - 1; ++row) {
-            for (int col = 0; col < BOARD_WIDTH - ((row + gs.board.even) % 2); ++col) {
-                if (row > BOARD_HEIGHT + off - 1)
-                    removeTile(gs, {row, col});
-                else
-                    addTile(gs, {row, col}, gs.board.things[row - off][col]);
-
-            }
-        }
-    } else {
-        for (int row = BOARD_HEIGHT - 1; row >= 0; --row) {
-            for (int col = 0; col < BOARD_WIDTH - ((row + gs.board.even) % 2); ++col) {
-                if (row < off)
-                    removeTile(gs, {row, col});
-                else
-                    addTile(gs, {row, col}, gs.board.things[row - off][col]);
-            }
-        }
-    }
-}
-
-void setNext(GameState& gs) {
-    gs.gun.next.shp = (unsigned char)getRandVal(gs, 0, COLORS.size() - 1);
-    gs.gun.next.clr = (unsigned char)getRandVal(gs, 0, COLORS.size() - 1);
-    gs.gun.next.sym = (unsigned char)getRandVal(gs, 0, COLORS.size() - 1);
-    gs.gun.nextArmed = true;
-}
-
-void rearm(GameState& gs) {
-    if (!gs.gun.nextArmed)
-        setNext(gs);
-    gs.gun.armed = gs.gun.next;
-    setNext(gs);
-    gs.rearmTime = getTime(gs);
-}
-
-void swapExtra(GameState& gs) {
-    if (gs.gun.extraArmed) {
-        auto e = gs.gun.extra;
-        gs.gun.extra = gs.gun.armed;
-        gs.gun.armed = e;
-        gs.gun.firstSwap = false;
-    } else {
-        gs.gun.extra = gs.gun.armed;
-        gs.gun.extraArmed = true;
-        rearm(gs);
-    }
-    playSound(gs, gs.ga.p->whoosh[1]);
-    gs.swapTime = getTime(gs);
+    gs.tmp.particles.spawn(pos.x, pos.y, vel.x, vel.y, ParticleLook{thing});
 }
 
 void loadAssets(GameAssets& ga, GameState& gs) {
@@ -290,6 +133,20 @@ void loadAssets(GameAssets& ga, GameState& gs) {
     ga.postProcFragShader = LoadShaderFromMemory(NULL, (const char*)res_post_proc_fs);
     ga.maskFragShader = LoadShaderFromMemory(NULL, (const char*)res_mask_fs);
 #endif
+    ga.maskRow.locate(ga.maskFragShader, "maskRow");
+#ifdef PLATFORM_ANDROID
+    auto boardShaderStr = prepShader((unsigned char*)res_board_vs);
+    ga.boardShader = LoadShaderFromMemory((const char*)boardShaderStr.c_str(), NULL);
+#else
+    ga.boardShader = LoadShaderFromMemory((const char*)res_board_vs, NULL);
+#endif
+    ga.boardMaterial = LoadMaterialDefault();
+    ga.boardMaterial.shader = ga.boardShader;
+    ga.boardMaterial.maps[MATERIAL_MAP_DIFFUSE].texture = ga.tiles;
+    ga.aimMaterial = LoadMaterialDefault();
+    ga.board.boardOffset.locate(ga.boardShader, "boardOffset");
+    ga.board.shakeSeed.locate(ga.boardShader, "shakeSeed");
+    ga.board.shakeStr.locate(ga.boardShader, "shakeStr");
 
     char8_t _allChars[228] = u8" !\"#$%&\'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~абвгдеёжзийклмнопрстуфхцчшщъыьэюяАБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
     int c; auto cdpts = LoadCodepoints((const char*)_allChars, &c);
@@ -314,26 +171,91 @@ void loadUserData(GameState& gs) {
 void setStuff(const GameAssets* ga, RenderTexture& rt, GameState& gs) {
     gs.ga.p = ga;
     loadUserData(gs);
-    gs.tmp.renderTex = IsRenderTextureValid(rt) ? rt : LoadRenderTexture(GetScreenWidth(), GetScreenHeight());;
-    SetTextureWrap(gs.tmp.renderTex.texture, TEXTURE_WRAP_CLAMP);
+    gs.tmp.renderTex = rt;
+}
+
+// Largest integer fraction of the screen renderTex can be without an art pixel
+// shrinking below MIN_SCALED_TILE_PIXEL target pixels
+int pickRenderScale(const GameState& gs) {
+    int scale = 1;
+    while (scale < MAX_RENDER_SCALE && TILE_PIXEL / (scale + 1) >= MIN_SCALED_TILE_PIXEL)
+        ++scale;
+    return scale;
+}
+
+// (Re)allocates renderTex at 1/renderScale of the screen when it is missing or the
+// wanted size changed. It is upscaled with nearest filtering, so pixel art stays sharp.
+void updateRenderTex(GameState& gs) {
+    int scale = pickRenderScale(gs);
+    int w = (GetScreenWidth() + scale - 1) / scale, h = (GetScreenHeight() + scale - 1) / scale;
+    auto& rt = gs.tmp.renderTex;
+    if (IsRenderTextureValid(rt) && rt.texture.width == w && rt.texture.height == h && gs.tmp.renderScale == scale)
+        return;
+    if (IsRenderTextureValid(rt))
+        UnloadRenderTexture(rt);
+    rt = LoadRenderTexture(w, h);
+    SetTextureFilter(rt.texture, TEXTURE_FILTER_POINT);
+    SetTextureWrap(rt.texture, TEXTURE_WRAP_CLAMP);
+    gs.tmp.renderScale = scale;
+    gs.tmp.sceneDrawn = false;
+}
+
+// Frees what the state put on the GPU; the assets stay with the window
+DLL_EXPORT void deinit(GameState& gs)
+{
+    auto& rt = gs.tmp.renderTex;
+    if (IsRenderTextureValid(rt))
+        UnloadRenderTexture(rt);
+    rt = {};
+    gs.tmp.boardMesh.mesh.unload();
+    gs.tmp.aimMesh.mesh.unload();
+    gs.tmp.rippleGrid.mesh.unload();
+    MemFree(gs.tmp.rippleGrid.material.maps);  // not UnloadMaterial, the shader is an asset
+    gs.tmp.rippleGrid.material = {};
+}
+
+// Everything is still drawn in screen coordinates; the camera scales it into renderTex
+void beginScene(const GameState& gs) {
+    BeginTextureMode(gs.tmp.renderTex);
+    ClearBackground(BLACK);
+    BeginMode2D(Camera2D{Vector2Zero(), Vector2Zero(), 0.0f, 1.0f / gs.tmp.renderScale});
+}
+
+void endScene() {
+    EndMode2D();
+    EndTextureMode();
 }
 
 DLL_EXPORT void setState(GameState& gs, const GameState& ngs)
 {
     const GameAssets* ga = gs.ga.p;
     auto rt = gs.tmp.renderTex;
-    gs = ngs;
+    gs = ngs;  // the GpuLocal meshes stay gs's own, built for the old board
+    gs.tmp.boardMesh.dirty = true;
+    gs.tmp.aimMesh.dirty = true;
+    gs.tmp.rippleGrid.width = 0;  // redo the whole grid for the new shockwaves
     setStuff(ga, rt, gs);
 }
 
+SimFrame getSimFrame(const GameState& gs) {
+    return {GetTime() + gs.tmp.timeOffset, GetFrameTime(), (float)GetScreenWidth(), (float)GetScreenHeight()};
+}
+
 void reset(GameState& gs) {
-    setState(gs, {0});
-    gs.seed = rand() % std::numeric_limits<int>::max();
-    for (int i = 0; i < gs.board.things.size(); ++i)
-        std::fill(gs.board.things[i].begin(), gs.board.things[i].end(), Tile());
-    generateRows(gs, BOARD_HEIGHT - gs.board.nRowsGap);
-    rearm(gs);
-    gs.gameStartTime = getTime(gs);
+    auto rt = gs.tmp.renderTex;
+    auto boardMesh = std::move(gs.tmp.boardMesh);
+    auto aimMesh = std::move(gs.tmp.aimMesh);
+    auto rippleGrid = std::move(gs.tmp.rippleGrid);
+    resetInPlace(gs.usr);
+    resetInPlace(gs.tmp);
+    gs.tmp.boardMesh = std::move(boardMesh);
+    gs.tmp.boardMesh.dirty = true;
+    gs.tmp.aimMesh = std::move(aimMesh);
+    gs.tmp.aimMesh.dirty = true;
+    gs.tmp.rippleGrid = std::move(rippleGrid);
+    setStuff(gs.ga.p, rt, gs);
+    setFrame(gs, getSimFrame(gs));
+    resetGame(gs, rand() % std::numeric_limits<int>::max());
 }
 
 DLL_EXPORT void init(GameAssets& ga, GameState& gs)
@@ -350,534 +272,243 @@ DLL_EXPORT void init(GameAssets& ga, GameState& gs)
     reset(gs);
 }
 
-void shootAndRearm(GameState& gs) {
-    gs.firstShotFired = true;
-    gs.bullet.exists = true;
-    gs.bullet.rebouncing = false;
-    float dir = gs.gun.dir + PI * 0.5f;
-    gs.bullet.thing = gs.gun.armed;
-    gs.bullet.vel = BULLET_SPEED * Vector2{cos(dir), -sin(dir)};
-    auto brec = getBoardRect(gs);
-    gs.bullet.pos = {(float)brec.x + brec.width * 0.5f, (float)GetScreenHeight() - TILE_RADIUS};
-    playSound(gs, gs.ga.p->whoosh[0]);
-    rearm(gs);
-}
-
-bool checkMatch(const Thing& th1, const Thing& th2, int param) {
-    if (th1.bomb || th2.bomb)
-        return false;
-    switch (param) {
-        case 0: return th1.clr == th2.clr;
-        case 1: return th1.shp == th2.shp;
-        case 2: return th1.sym == th2.sym;
-    }
-    return false;
-}
-
-void checkDropRecur(GameState& gs, const ThingPos& pos, const Thing& thing, int param, Arena<MAX_TODROP, ThingPos>& todrop, std::map<int, std::map<int, bool>>& visited, bool first = true)
-{
-    if (visited.count(pos.row) && visited[pos.row].count(pos.col))
-        return;
-    visited[pos.row][pos.col] = true;
-    if (checkBounds(gs, pos)) {
-        const auto& tile = getTile(gs, pos);
-        bool match = checkMatch(tile.thing, thing, param);
-        if ((tile.exists && match) || first) {
-            if (tile.exists && match) todrop.acquire(pos);
-            for (auto& n : getNeighs(gs, pos))
-                if (getTile(gs, n).exists) checkDropRecur(gs, n, thing, param, todrop, visited, false);
-        }
-    }
-}
-
-bool isConnectedToTopRecur(GameState& gs, const ThingPos& pos, std::map<int, std::map<int, bool>>& visited)
-{
-    if (visited.count(pos.row) && visited[pos.row].count(pos.col))
-        return false;
-    if (pos.row == 21 && pos.col == 5)
-        std::cout << "\n";
-    visited[pos.row][pos.col] = true;
-    if (checkBounds(gs, pos)) {
-        auto& tile = getTile(gs, pos);
-        if (tile.exists) {
-            bool connected = (pos.row == gs.board.nFulRowsTop - 1);
-            for (auto& n : getNeighs(gs, pos))
-                if (getTile(gs, n).exists && !connected) connected |= isConnectedToTopRecur(gs, n, visited);
-            visited[pos.row][pos.col] = connected;
-            return connected;
-        }
-    }
-    return false;
-}
-
-void checkUnconnectedRecur(GameState& gs, const ThingPos& pos, std::map<int, std::map<int, bool>>& visited, Arena<MAX_TODROP, ThingPos>& uncon, bool check = true)
-{
-    if (visited.count(pos.row) && visited[pos.row].count(pos.col))
-        return;
-    if (pos.row == 20 && pos.col == 6)
-        std::cout << "\n";
-    visited[pos.row][pos.col] = true;
-    std::map<int, std::map<int, bool>> visCon;
-    if (checkBounds(gs, pos) && (!check || !isConnectedToTopRecur(gs, pos, visCon))) {
-        auto& tile = getTile(gs, pos);
-        if (tile.exists) {
-            uncon.acquire(pos);
-            for (auto& n : getNeighs(gs, pos))
-                if (getTile(gs, n).exists) checkUnconnectedRecur(gs, n, visited, uncon, false);
-        }
-    }
-}
-
-void addShakeRecur(GameState& gs, const ThingPos& pos, std::map<int, std::map<int, bool>>& visited, const Thing& thing, int param, float shake, int depth, int curdepth = 0, bool mtchstreak = true)
-{
-    if (visited.count(pos.row) && visited[pos.row].count(pos.col) || curdepth >= depth)
-        return;
-    visited[pos.row][pos.col] = true;
-    auto& tile = getTile(gs, pos);
-    if (tile.exists && curdepth == 0) tile.shake = std::max(tile.shake, shake / (curdepth + 1));
-    if (tile.exists || curdepth == 0) {
-        for (int i = 0; i < 6; ++i) {
-            if (checkBounds(gs, TOGO[i])) {
-                auto& n = getTile(gs, TOGO[i]);
-                bool match = checkMatch(n.thing, thing, param);
-                bool samecolor = (mtchstreak && match);
-                if (n.exists)
-                    n.shake = std::max(n.shake, samecolor ? shake : (shake / (curdepth + 2)));
-            }
-        }
-        if (mtchstreak) {
-            for (int i = 0; i < 6; ++i) {
-                if (checkBounds(gs, TOGO[i])) {
-                    auto& n = getTile(gs, TOGO[i]);
-                    bool match = checkMatch(n.thing, thing, param);
-                    if (n.exists && match)
-                        addShakeRecur(gs, n.pos, visited, thing, param, shake, depth, curdepth, true);
-                }
-            }
-        }
-        if (!mtchstreak || curdepth == 0) {
-            for (int i = 0; i < 6; ++i) {
-                if (checkBounds(gs, TOGO[i])) {
-                    auto& n = getTile(gs, TOGO[i]);
-                    bool match = checkMatch(n.thing, thing, param);
-                    if (n.exists && !match)
-                        addShakeRecur(gs, n.pos, visited, thing, param, shake, depth, curdepth + 1, false);
-                }
-            }
-        }
-    }
-}
-
-void checkLines(GameState& gs) {
-    auto extraRows = countBotEmpRows(gs) - gs.board.nRowsGap;
-    if (extraRows > 0) {
-        shiftBoard(gs, extraRows);
-        generateRows(gs, extraRows);
-        gs.board.pos -= ROW_HEIGHT * extraRows;
-        gs.board.moveTime = gs.board.totalMoveTime = BOARD_MOVE_TIME_PER_LINE * extraRows;
-    }
-}
-
 void addDrop(GameState& gs, Vector2 pos) {
-    gs.tmp.shDropCenters[gs.tmp.shNDrops] = pos;
-    gs.tmp.shDropTimes[gs.tmp.shNDrops] = getTime(gs);
-    gs.tmp.shNDrops++;
-}
-
-void triggerBomb(GameState& gs, const ThingPos& pos) {
-    auto& thing = getTile(gs, pos).thing;
-    thing.triggered = true;
-    thing.triggerTime = getTime(gs);
-    gs.bullet.exists = false;
-    playSound(gs, gs.ga.p->sizzle);
-    addParticle(gs, gs.bullet.thing, gs.bullet.pos, {-gs.bullet.vel.x, -400.0f - 100.0f * RAND_FLOAT});
-}
-
-void checkDrop(GameState& gs, const ThingPos& pos, const Thing& thing, int minToDrop = 0) {
-    int bestK = 0, bestScore = 0;
-    Arena<MAX_TODROP, ThingPos> todrops[3];
-    Arena<MAX_TODROP, ThingPos> uncons[3];
-    auto exists = getTile(gs, pos).exists;
-    int lim = (exists ? minToDrop : (minToDrop - 1));
-    for (int k = 0; k < gs.usr.n_params; ++k) {
-        std::map<int, std::map<int, bool>> vis;
-        checkDropRecur(gs, pos, thing, k, todrops[k], vis);
-        int count = todrops[k].count();
-        if (count >= lim) {
-            for (int i = 0; i < todrops[k].count(); ++i)
-                removeTile(gs, todrops[k].at(i));
-            std::map<int, std::map<int, bool>> vis2;
-            for (int i = 0; i < todrops[k].count(); ++i) {
-                auto& td = todrops[k].at(i);
-                auto& tile = getTile(gs, td);
-                for (auto& n : getNeighs(gs, td)) {
-                    if (getTile(gs, n).exists)
-                        checkUnconnectedRecur(gs, n, vis2, uncons[k]);
-                }
-            }
-            for (int i = 0; i < todrops[k].count(); ++i)
-                addTile(gs, todrops[k].at(i), getTile(gs, todrops[k].at(i)), true, true);
-            if (!exists) todrops[k].acquire(pos);
-        }
-        int score = todrops[k].count() + uncons[k].count();
-        if (bestScore < score) {
-            bestScore = score;
-            bestK = k;
-        }
-    }
-    std::map<int, std::map<int, bool>> vis2;
-    addShakeRecur(gs, pos, vis2, thing, bestK, SHAKE_TIME, SHAKE_DEPTH);
-    gs.board.todrop = todrops[bestK];
-    gs.board.uncon = uncons[bestK];
-}
+    // Lower tiers keep fewer waves: make room by dropping the oldest
+    size_t cap = qualityTier(gs).maxShockwaves, live = gs.tmp.shockwaves.count();
+    size_t drop = (live >= cap) ? live - cap + 1 : 0;
+    gs.tmp.shockwaves.releaseIf([&](const Shockwave&) {
+        if (!drop)
+            return false;
+        --drop;
+        return true;
+    });
+    gs.tmp.shockwaves.acquire(Shockwave{pos, getTime(gs)});
+}
+
+SimInput readInput(GameState& gs) {
+    PROF_ZONE(INPUT);
+    SimInput in;
+    float h = GetScreenHeight();
+#ifdef PLATFORM_ANDROID
+    in.aim = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+#else
+    in.aim = fabs(GetMouseDelta().x) > 0;
+#endif
+    in.aimPos = {(float)GetMouseX(), (float)GetMouseY()};
+    in.turn = IsKeyDown(KEY_LEFT) ? 1 : (IsKeyDown(KEY_RIGHT) ? -1 : 0);
 
-void explodeBomb(GameState& gs, const ThingPos& pos_);
-
-void doDrop(GameState& gs, int minToDrop = 0, bool shatter = true, Vector2 vel = Vector2Zero()) {
-    if (gs.board.todrop.count() >= minToDrop) {
-        for (int i = 0; i < gs.board.todrop.count(); ++i) {
-            auto& td = gs.board.todrop.at(i);
-            removeTile(gs, td);
-            auto pixpos = getPixByPos(gs, td);
-            if (shatter) {
-                addAnimation(gs, &gs.ga.p->splash, SPLASH_TIME, pixpos, COMBO_COLORS[gs.board.lastDropCombo - 1]);
-                playSound(gs, gs.ga.p->shatter[GetRandomValue(0, 1)]);
-                addShatteredParticles(gs, getTile(gs, td).thing, pixpos);
-            } else {
-                addParticle(gs, getTile(gs, td).thing, getPixByPos(gs, td), vel);
-            }
-            addScorePoints(gs, pixpos, COMBO_COLORS[gs.board.lastDropCombo - 1], gs.board.lastDropCombo);
-        }
-        for (int i = 0; i < gs.board.uncon.count(); ++i) {
-            auto& un = gs.board.uncon.at(i);
-            removeTile(gs, un);
-            auto pixpos = getPixByPos(gs, un);
-            addParticle(gs, getTile(gs, un).thing, pixpos, Vector2Zero());
-            addScorePoints(gs, pixpos, COMBO_COLORS[gs.board.lastDropCombo - 1], gs.board.lastDropCombo);
-        }
-    }
-    gs.board.todrop.clear();
-    gs.board.uncon.clear();
-}
+#ifdef PLATFORM_ANDROID
+    bool primary = IsMouseButtonReleased(MOUSE_BUTTON_LEFT);
+#else
+    bool primary = IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+#endif
+    in.restart = primary;
+    in.fire = primary && !IsKeyDown(KEY_LEFT_CONTROL) && GetMouseY() < h - TILE_RADIUS * 2.0f;
 
-void explodeBomb(GameState& gs, const ThingPos& pos) {
-    auto& thing = getTile(gs, pos).thing;
-    auto pixpos = getPixByPos(gs, pos);
-    addDrop(gs, pixpos);
-    playSound(gs, gs.ga.p->sndexp);
-    addAnimation(gs, &gs.ga.p->explosion, EXPLOSION_TIME, pixpos);
-    auto& tile = getTile(gs, pos);
-    removeTile(gs, pos);
-    for (auto& n : getNeighs(gs, pos)) {
-        auto ntile = getTile(gs, n);
-        if (ntile.exists) {
-            if (ntile.thing.bomb) {
-                triggerBomb(gs, n);
-            } else {
-                checkDrop(gs, n, ntile.thing);
-                if (gs.board.todrop.count())
-                    doDrop(gs);
-            }
-        }
-        for (auto& nn : getNeighs(gs, n)) {
-            auto nntile = getTile(gs, nn);
-            if (nntile.exists) {
-                if (nntile.thing.bomb) {
-                    //triggerBomb(gs, nntile.pos);
-                    explodeBomb(gs, nntile.pos);
-                } else {
-                    checkDrop(gs, nntile.pos, nntile.thing);
-                    doDrop(gs, 0, false, 300.0f * Vector2Normalize(getPixByPos(gs, nntile.pos) - pixpos));
-                }
-            }
-        }
-    }
-    addScorePoints(gs, pixpos, COMBO_COLORS[gs.board.lastDropCombo - 1], gs.board.lastDropCombo);
-}
+    static int touchCount = 0;
+#ifdef PLATFORM_ANDROID
+    in.swap = (GetTouchPointCount() == 2 && touchCount == 1) || (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && GetMouseY() > h - TILE_RADIUS * 2.0f);
+#else
+    in.swap = IsKeyPressed(KEY_LEFT_CONTROL) || IsMouseButtonPressed(MOUSE_BUTTON_RIGHT) || (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && GetMouseY() > h - TILE_RADIUS * 2.0f);
+#endif
+    touchCount = GetTouchPointCount();
 
-void checkBomb(GameState& gs, const ThingPos& pos) {
-    auto& tile = getTile(gs, pos);
-    if (tile.thing.triggered) {
-        tile.shake = std::clamp((getTime(gs) - tile.thing.triggerTime)/BOMB_TRIGGER_TIME, 0.0, 1.0);
-        if (getTime(gs) - tile.thing.triggerTime > BOMB_TRIGGER_TIME)
-            explodeBomb(gs, pos);
+    if (IsKeyDown(KEY_LEFT_CONTROL)) {
+        in.editAdd = IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+        in.editRemove = IsMouseButtonPressed(MOUSE_BUTTON_RIGHT);
+        in.editPos = {(float)GetMouseX(), (float)GetMouseY()};
     }
-}
-
-void flyBullet(GameState& gs, float delta)
-{
-    if (gs.bullet.exists)
-        gs.bullet.pos += gs.bullet.vel * delta;
-    if (gs.bullet.pos.y + TILE_RADIUS < 0)
-        gs.bullet.exists = false;
-
-    auto brect = getBoardRect(gs);
-    auto bulpos = getPosByPix(gs, gs.bullet.pos);
-
-    if (gs.bullet.rebouncing) {
-        gs.bullet.pos = GetSplinePointBezierQuad(gs.bullet.pos - Vector2{0, gs.board.pos}, gs.bullet.rebCp, gs.bullet.rebEnd, gs.bullet.rebounce) + Vector2{0, gs.board.pos};
-        float prog = (float)(getTime(gs) - gs.bullet.rebTime)/BULLET_REBOUNCE_TIME;
-        if (prog > 1.0f) {
-            gs.bullet.exists = false;
-            addTile(gs, gs.bullet.lstEmp, Tile{true, gs.bullet.lstEmp, gs.bullet.thing});
-            doDrop(gs, N_TO_DROP);
-            gs.bullet.rebouncing = false;
-        } else {
-            gs.bullet.rebounce = easeOutBounce(prog);
-        }
-    } else if (gs.bullet.exists) {
-        if (gs.bullet.pos.x - BULLET_RADIUS_H < brect.x || gs.bullet.pos.x + BULLET_RADIUS_H > brect.x + brect.width) {
-            playSound(gs, gs.ga.p->clang[GetRandomValue(0, 2)]);
-            addAnimation(gs, &gs.ga.p->splash, SPLASH_TIME, gs.bullet.pos + Vector2{gs.bullet.vel.x/abs(gs.bullet.vel.x), 0});
-            gs.bullet.vel.x *= -1.0f;
-        }
-
-        if (!getTile(gs, bulpos).exists)
-            gs.bullet.lstEmp = {bulpos.row, bulpos.col};
-
-        for (int i = 0; i < BOARD_HEIGHT; ++i) {
-            for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j) {
-                const auto& tile = gs.board.things[i][j];
-                if (tile.exists) {
-                    Vector2 tpos = getPixByPos(gs, {i, j});
-                    if (Vector2DistanceSqr(tpos, gs.bullet.pos) < BULLET_HIT_DIST_SQR ||
-                        Vector2DistanceSqr(tpos, gs.bullet.pos + Vector2Normalize(gs.bullet.vel) * BULLET_RADIUS_H) < BULLET_HIT_DIST_SQR) {
-                        playSound(gs, gs.ga.p->clang[GetRandomValue(0, 2)]);
-                        addAnimation(gs, &gs.ga.p->splash, SPLASH_TIME, 0.5f * (tpos + getPixByPos(gs, gs.bullet.lstEmp)));
-                        gs.board.lastDropCombo = gs.combo;
-                        if (tile.thing.bomb) {
-                            triggerBomb(gs, {i, j});
-                            gs.combo = std::clamp(gs.combo + 1, 1, MAX_COMBO);
-                            addScorePoints(gs, gs.bullet.pos, COMBO_COLORS[gs.board.lastDropCombo - 1], gs.board.lastDropCombo);
-                        } else {
-                            checkDrop(gs, gs.bullet.lstEmp, gs.bullet.thing, N_TO_DROP);
-                            gs.bullet.rebouncing = true;
-                            gs.bullet.rebounce = 0.0f;
-                            gs.bullet.rebCp = (gs.bullet.pos - Vector2Normalize(gs.bullet.vel) * BULLET_REBOUNCE)- Vector2{0, gs.board.pos};
-                            gs.bullet.rebEnd = (getPixByPos(gs, gs.bullet.lstEmp)) - Vector2{0, gs.board.pos};
-                            gs.bullet.rebTime = getTime(gs);
-                            if (gs.board.todrop.count() >= N_TO_DROP)
-                                gs.combo = std::clamp(gs.combo + 1, 1, MAX_COMBO);
-                            else
-                                gs.combo = std::clamp(gs.combo - 1, 1, MAX_COMBO);
-                        }
-                        break;
-                    }
+    in.cycleParams = IsKeyPressed(KEY_Q);
+    in.easeDifficulty = IsKeyPressed(KEY_Z);
+    return in;
+}
+
+void applySimEvents(GameState& gs) {
+    const auto& ga = *gs.ga.p;
+    for (int i = 0; i < gs.tmp.events.count(); ++i) {
+        const auto& ev = gs.tmp.events.get(i);
+        switch (ev.type) {
+            case SimEventType::SOUND:
+                switch ((SimSound)ev.id) {
+                    case SimSound::CLANG: playSound(gs, ga.clang[GetRandomValue(0, 2)]); break;
+                    case SimSound::WHOOSH: playSound(gs, ga.whoosh[0]); break;
+                    case SimSound::SWAP: playSound(gs, ga.whoosh[1]); break;
+                    case SimSound::SIZZLE: playSound(gs, ga.sizzle); break;
+                    case SimSound::EXPLOSION: playSound(gs, ga.sndexp); break;
+                    case SimSound::SHATTER: playSound(gs, ga.shatter[GetRandomValue(0, 1)]); break;
+                    case SimSound::FAIL: playSound(gs, ga.fail); break;
+                    case SimSound::SHAKE: playSound(gs, ga.shake); break;
                 }
-            }
-            if (gs.bullet.rebouncing)
+                break;
+            case SimEventType::ANIMATION:
+                if ((SimAnim)ev.id == SimAnim::EXPLOSION)
+                    addAnimation(gs, &ga.explosion, EXPLOSION_TIME, ev.pos, ev.col);
+                else
+                    addAnimation(gs, &ga.splash, SPLASH_TIME, ev.pos, ev.col);
+                break;
+            case SimEventType::PARTICLE: addParticle(gs, ev.thing, ev.pos, ev.vel); break;
+            case SimEventType::SHATTER: addShatteredParticles(gs, ev.thing, ev.pos, ev.id); break;
+            case SimEventType::SCORE: spawnScorePoints(gs, ev.pos, ev.col, ev.n); break;
+            case SimEventType::SHOCKWAVE: addDrop(gs, ev.pos); break;
+            case SimEventType::RECORD: saveUserData(gs); break;
+            case SimEventType::RESET:
+                gs.tmp.particles.clear();
+                gs.tmp.animations.clear();
+                gs.tmp.scorePoints.clear();
+                gs.tmp.visScore = 0;
+                gs.tmp.shockwaves.clear();
+                gs.tmp.boardMesh.dirty = true;
+                gs.tmp.aimMesh.dirty = true;
                 break;
         }
     }
 }
 
 void flyScorePoints(GameState& gs) {
-    bool someNotDone = false;
-    for (int i = 0; i < gs.tmp.scorePoints.count(); ++i) {
-        auto& sp = gs.tmp.scorePoints.at(i);
-        bool wasDone = sp.done;
+    PROF_ZONE(EFFECTS);
+    gs.tmp.scorePoints.releaseIf([&](ScorePoint& sp) {
         sp.done = (getTime(gs) - sp.spawnTime > sp.flyTime);
         if (sp.done) {
-            if (!wasDone) {
-                gs.tmp.visScore++;
-                if (getTime(gs) - gs.tmp.lastScoreSnd > SCORE_SND_CD) {
-                    playSound(gs, gs.ga.p->pop[GetRandomValue(0, 1)]);
-                    gs.tmp.lastScoreSnd = getTime(gs);
-                }
+            gs.tmp.visScore += sp.value;
+            if (getTime(gs) - gs.tmp.lastScoreSnd > SCORE_SND_CD) {
+                playSound(gs, gs.ga.p->pop[GetRandomValue(0, 1)]);
+                gs.tmp.lastScoreSnd = getTime(gs);
             }
-        } else {
-            someNotDone = true;
         }
-    }
-    if (!someNotDone)
-        gs.tmp.scorePoints.clear();
+        return sp.done;
+    });
 }
 
 void flyParticles(GameState& gs) {
-    bool someInFrame = false;
-    for (int i = 0; i < gs.tmp.particles.count(); ++i) {
-        auto& prt = gs.tmp.particles.at(i);
-        if (prt.exists) {
-            prt.pos += prt.vel * getFrameTime(gs);
-            prt.vel += GRAVITY * Vector2{0.0f, 1.0f} * getFrameTime(gs);
-            if (prt.pos.y < GetScreenHeight())
-                someInFrame = true;
-        }
-    }
-    if (!someInFrame)
-        gs.tmp.particles.clear();
+    PROF_ZONE(EFFECTS);
+    gs.tmp.particles.step(getFrameTime(gs), GRAVITY, GetScreenHeight() + TILE_RADIUS);
 }
 
+// Drops every wave past WAVE_FADE_TIME on its own, keeping the rest oldest first
 void checkDrops(GameState& gs) {
-    bool someStillGoing = false;
-    for (int i = 0; i < gs.tmp.shNDrops; ++i) {
-        if (getTime(gs) - gs.tmp.shDropTimes[i] < WAVE_FADE_TIME) {
-            someStillGoing = true;
-            break;
-        }
-    }
-    if (!someStillGoing)
-        gs.tmp.shNDrops = 0;
+    PROF_ZONE(EFFECTS);
+    gs.tmp.shockwaves.releaseIf([&](const Shockwave& sw) {
+        return getTime(gs) - sw.startTime >= WAVE_FADE_TIME;
+    });
 }
 
 void checkAnimations(GameState& gs) {
-    bool someStillGoing = false;
-    for (int i = 0; i < gs.tmp.animations.count(); ++i) {
-        auto& anim = gs.tmp.animations.at(i);
-        if (!anim.done) {
-            anim.done = ((getTime(gs) - anim.startTime) / anim.interval > 1.0f);
-            someStillGoing = true;
-        }
-    }
-    if (!someStillGoing)
-        gs.tmp.animations.clear();
-}
-
-void gameOver(GameState& gs) {
-    if (gs.gameOver)
-        return;
-    gs.gameOver = true;
-    gs.gameOverTime = getTime(gs);
-    gs.bullet.exists = false;
-    auto brec = getBoardRect(gs);
-    Vector2 gunPos = {brec.x + brec.width * 0.5f, (float)GetScreenHeight() - TILE_RADIUS};
-    addParticle(gs, gs.gun.armed, gunPos, Vector2{50.0f * RAND_FLOAT_SIGNED, -400.0f - 100.0f * RAND_FLOAT});
-    addParticle(gs, gs.gun.next, {brec.x + brec.width - TILE_RADIUS, GetScreenHeight() - TILE_RADIUS}, Vector2{50.0f * RAND_FLOAT_SIGNED, -400.0f - 100.0f * RAND_FLOAT});
-    if (gs.gun.extraArmed)
-        addParticle(gs, gs.gun.extra, {brec.x + TILE_RADIUS, GetScreenHeight() - TILE_RADIUS}, Vector2{50.0f * RAND_FLOAT_SIGNED, -400.0f - 100.0f * RAND_FLOAT});
-    if (!gs.alteredDifficulty && gs.score > gs.usr.bestScore) {
-        gs.usr.bestScore = gs.score;
-        saveUserData(gs);
-    }
-    playSound(gs, gs.ga.p->fail);
-    playSound(gs, gs.ga.p->shake);
-}
-
-void update(GameState& gs)
-{
-    if (gs.gameStartTime + GAME_START_TIME < getTime(gs)) {
-        auto delta = getFrameTime(gs) / UPDATE_ITS;
-        auto brec = getBoardRect(gs);
-#ifdef PLATFORM_ANDROID
-        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
-#else
-        if (fabs(GetMouseDelta().x) > 0) {
-#endif
-            Vector2 gunPos = {(float)brec.x + brec.width * 0.5f, (float)GetScreenHeight() - TILE_RADIUS};
-            gs.gun.dir = atan2(gunPos.y - GetMouseY(), GetMouseX() - gunPos.x) - PI * 0.5f;
-        } else if (IsKeyDown(KEY_LEFT)) {
-            gs.gun.dir += gs.gun.speed * delta;
-            gs.gun.speed += GUN_ACC * delta;
-        } else if (IsKeyDown(KEY_RIGHT)) {
-            gs.gun.dir -= gs.gun.speed * delta;
-            gs.gun.speed += GUN_ACC * delta;
-        } else {
-            gs.gun.speed = GUN_START_SPEED;
-        }
-        gs.gun.speed = std::clamp(gs.gun.speed, GUN_START_SPEED, GUN_FULL_SPEED);
-        gs.gun.dir = std::clamp(gs.gun.dir, -PI * 0.45f, PI * 0.45f);
-
-        flyBullet(gs, delta);
+    PROF_ZONE(EFFECTS);
+    gs.tmp.animations.releaseIf([&](const Animation& anim) {
+        return (getTime(gs) - anim.startTime) / anim.interval > 1.0f;
+    });
+}
+
+// GPU buffers for the largest board, uploaded once; quad q's indices and texcoords2.x never change
+void loadBoardMesh(BoardMesh& bm) {
+    constexpr int QUADS = BOARD_WIDTH * BOARD_HEIGHT;
+    bm.vertices.assign(QUADS * 4 * 3, 0.0f);
+    bm.texcoords.assign(QUADS * 4 * 2, 0.0f);
+    bm.shake.assign(QUADS * 4 * 2, 0.0f);
+    bm.colors.assign(QUADS * 4 * 4, 0);
+    bm.indices.resize(QUADS * 6);
+    bm.quadTiles.resize(QUADS);
+    for (int q = 0; q < QUADS; ++q) {
+        unsigned short v = q * 4;
+        unsigned short quad[6] = {v, (unsigned short)(v + 1), (unsigned short)(v + 2), v, (unsigned short)(v + 2), (unsigned short)(v + 3)};
+        std::copy(quad, quad + 6, &bm.indices[q * 6]);
+        for (int k = 0; k < 4; ++k)
+            bm.shake[(q * 4 + k) * 2] = q;
     }
-}
-
-void updateOnce(GameState& gs)
-{
-    if (gs.gameOver) {
-        for (int i = 0; i < BOARD_HEIGHT; ++i) {
-            for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j) {
-                const Tile& tile = gs.board.things[i][j];
-                if (tile.exists) {
-                    if ((getTime(gs) - gs.gameOverTime) > (GAME_OVER_TIME_PER_ROW * (BOARD_HEIGHT - 1 - i))) {
-                        gs.board.things[i][j].exists = false;
-                        Vector2 tpos = getPixByPos(gs, {i, j});
-                        if (tpos.y > 0) {
-                            playSound(gs, gs.ga.p->clang[GetRandomValue(0, 2)]);
-                            addParticle(gs, gs.board.things[i][j].thing, getPixByPos(gs, {i, j}), Vector2{50.0f * RAND_FLOAT_SIGNED, -400.0f - 100.0f * RAND_FLOAT});
-                        }
-                    }
-                }
-            }
-        }
-        if (getTime(gs) > gs.gameOverTime + GAME_OVER_TIMEOUT) {
-#ifdef PLATFORM_ANDROID
-            if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT))
-#else
-            if ((IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_BUTTON_LEFT)))
-#endif
-                reset(gs);
-
-        }
-    } else if (gs.gameStartTime + GAME_START_TIME < getTime(gs)) {
-        for (int i = 0; i < BOARD_HEIGHT; ++i) {
-            for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j) {
-                Tile& tile = gs.board.things[i][j];
-                if (tile.exists) {
-                    if (tile.shake < SHAKE_TIME || gs.board.todrop.count() < N_TO_DROP - 1)
-                        tile.shake = std::max(tile.shake - getFrameTime(gs), 0.0f);
-                    else
-                        tile.shake = std::min(tile.shake + getFrameTime(gs) * 2, MAX_SHAKE);
-                    Vector2 tpos = getPixByPos(gs, {i, j});
-                    if ((GetScreenHeight() - 2 * TILE_RADIUS) - (tpos.y + TILE_RADIUS) < 0)
-                        gameOver(gs);
-                    if (tile.thing.bomb)
-                        checkBomb(gs, {i, j});
-                }
+    bm.mesh.vertexCount = QUADS * 4;
+    bm.mesh.triangleCount = QUADS * 2;
+    bm.mesh.vertices = bm.vertices.data();
+    bm.mesh.texcoords = bm.texcoords.data();
+    bm.mesh.texcoords2 = bm.shake.data();
+    bm.mesh.colors = bm.colors.data();
+    bm.mesh.indices = bm.indices.data();
+    UploadMesh(&bm.mesh, true);
+    bm.mesh.vertexCount = bm.mesh.triangleCount = 0;
+}
+
+// Lays out a quad per existing tile with the sprite, size and tint drawThing would use
+void buildBoardMesh(GameState& gs) {
+    auto& bm = gs.tmp.boardMesh;
+    const auto& tiles = gs.ga.p->tiles;
+    Rectangle origin = getBoardRect(gs);
+    origin.x = origin.y = 0;
+    bm.flashPhase = int(floor(getTime(gs) * 20)) % 2;
+    bm.flashing = false;
+    int q = 0;
+    for (int i = 0; i < BOARD_HEIGHT; ++i) {
+        for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j) {
+            const Tile& tile = gs.board.things[i][j];
+            if (!tile.exists)
+                continue;
+            const Thing& thing = tile.thing;
+            ThingPos tpos = {0, (gs.usr.n_params == 1) ? 0 : thing.shp};
+            Vector2 sz = {TILE_SIZE, TILE_SIZE + 1.0f};
+            Color col = COLORS[thing.clr];
+            if (thing.bomb) {
+                tpos = {4, thing.triggered ? ((bm.flashPhase == 0) ? 4 : 5) : 3};
+                sz = {TILE_SIZE, TILE_SIZE};
+                col = WHITE;
+                bm.flashing |= thing.triggered;
             }
-        }
-
-        if (IsKeyDown(KEY_LEFT_CONTROL)) {
-            auto mpos = getPosByPix(gs, {(float)GetMouseX(), (float)GetMouseY()});
-            if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                addTile(gs, mpos, Tile{(mpos.col != (BOARD_WIDTH - 1)) || ((mpos.row + gs.board.even) % 2 == 0), {mpos.row, mpos.col},
-                                       {(unsigned char)getRandVal(gs, 0, COLORS.size() - 1), (unsigned char)getRandVal(gs, 0, COLORS.size() - 1), (unsigned char)getRandVal(gs, 0, COLORS.size() - 1)}});
-            } else if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) {
-                removeTile(gs, mpos);
+            Vector2 center = getPixByPos(gs, origin, {i, j});
+            float x0 = int(center.x - sz.x * TILE_PIXEL * 0.5f), y0 = int(center.y - sz.y * TILE_PIXEL * 0.5f);
+            float x1 = x0 + int(sz.x * TILE_PIXEL), y1 = y0 + int(sz.y * TILE_PIXEL);
+            float u0 = tpos.col * TILE_SIZE / tiles.width, v0 = tpos.row * TILE_SIZE / tiles.height;
+            float u1 = (tpos.col * TILE_SIZE + sz.x) / tiles.width, v1 = (tpos.row * TILE_SIZE + sz.y) / tiles.height;
+            // Same corner order as rlgl's quads: top-left, bottom-left, bottom-right, top-right
+            float xy[8] = {x0, y0, x0, y1, x1, y1, x1, y0};
+            float uv[8] = {u0, v0, u0, v1, u1, v1, u1, v0};
+            for (int k = 0; k < 4; ++k) {
+                int v = q * 4 + k;
+                bm.vertices[v * 3] = xy[k * 2];
+                bm.vertices[v * 3 + 1] = xy[k * 2 + 1];
+                bm.texcoords[v * 2] = uv[k * 2];
+                bm.texcoords[v * 2 + 1] = uv[k * 2 + 1];
+                bm.colors[v * 4] = col.r;
+                bm.colors[v * 4 + 1] = col.g;
+                bm.colors[v * 4 + 2] = col.b;
+                bm.colors[v * 4 + 3] = col.a;
             }
+            bm.quadTiles[q++] = {i, j};
         }
-
-        if (!IsKeyDown(KEY_LEFT_CONTROL) && GetMouseY() < GetScreenHeight() - TILE_RADIUS * 2.0f) {
-#ifdef PLATFORM_ANDROID
-            if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT) && !gs.bullet.exists)
-#else
-            if ((IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) && !gs.bullet.exists)
-#endif
-                shootAndRearm(gs);
-        }
-
-        static int touchCount = 0;
-#ifdef PLATFORM_ANDROID
-        if ((GetTouchPointCount() == 2 && touchCount == 1) || (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && GetMouseY() > GetScreenHeight() - TILE_RADIUS * 2.0f))
-#else
-        if (IsKeyPressed(KEY_LEFT_CONTROL) || IsMouseButtonPressed(MOUSE_BUTTON_RIGHT) || (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && GetMouseY() > GetScreenHeight() - TILE_RADIUS * 2.0f))
-#endif
-            swapExtra(gs);
-        touchCount = GetTouchPointCount();
-
-        if (gs.board.moveTime > 0 && gs.board.pos < 0) {
-            gs.board.pos = gs.board.pos * (1.0f - easeOutQuad(1.0f - gs.board.moveTime/gs.board.totalMoveTime));
-            gs.board.moveTime -= getFrameTime(gs);
-        }
-
-        if (IsKeyPressed(KEY_Q))
-            gs.usr.n_params = (gs.usr.n_params % 3) + 1;
-
-        if (gs.firstShotFired) {
-            if (gs.usr.velEnabled)
-                gs.board.pos += TILE_PIXEL * (gs.usr.accEnabled ? gs.board.speed : BOARD_CONST_SPEED) * getFrameTime(gs);
-            if (gs.usr.accEnabled)
-                gs.board.speed += BOARD_ACC * getFrameTime(gs);
-        }
-
-        if (IsKeyPressed(KEY_Z)) {
-            if (gs.usr.accEnabled)
-                gs.usr.accEnabled = false;
-            else
-                gs.usr.velEnabled = false;
-        }
-
-        checkLines(gs);
     }
+    UpdateMeshBuffer(bm.mesh, 0, bm.vertices.data(), q * 4 * 3 * sizeof(float), 0);
+    UpdateMeshBuffer(bm.mesh, 1, bm.texcoords.data(), q * 4 * 2 * sizeof(float), 0);
+    UpdateMeshBuffer(bm.mesh, 3, bm.colors.data(), q * 4 * 4, 0);
+    bm.mesh.vertexCount = q * 4;
+    bm.mesh.triangleCount = q * 2;
+    bm.version = gs.board.version;
+    bm.nParams = gs.usr.n_params;
+    bm.tilePixel = TILE_PIXEL;
+    bm.shaking = true;
+    bm.dirty = false;
+}
+
+// Rebuilds the board mesh if a tile, the tile size or a bomb's flash changed, then
+// uploads the shake amounts while anything shakes (and once more after it stops)
+void updateBoardMesh(GameState& gs) {
+    PROF_ZONE(EFFECTS);
+    auto& bm = gs.tmp.boardMesh;
+    if (!bm.mesh.vboId)  // no VAO id to check on GLES2 without the extension
+        loadBoardMesh(bm);
+    if (bm.dirty || bm.version != gs.board.version || bm.nParams != gs.usr.n_params || bm.tilePixel != TILE_PIXEL
+        || (bm.flashing && bm.flashPhase != int(floor(getTime(gs) * 20)) % 2))
+        buildBoardMesh(gs);
+
+    bool shaking = false;
+    int quads = bm.mesh.vertexCount / 4;
+    for (int q = 0; q < quads; ++q) {
+        auto pos = bm.quadTiles[q];
+        float amount = gs.gameOver ?
+            std::clamp((getTime(gs) - gs.gameOverTime)/std::max((GAME_OVER_TIME_PER_ROW * (BOARD_HEIGHT - 1 - pos.row)), 0.001f), 0.0, 1.0) :
+            gs.board.things[pos.row][pos.col].shake;
+        shaking |= (amount != 0);
+        for (int k = 0; k < 4; ++k)
+            bm.shake[(q * 4 + k) * 2 + 1] = amount;
+    }
+    if (shaking || bm.shaking)
+        UpdateMeshBuffer(bm.mesh, 5, bm.shake.data(), quads * 4 * 2 * sizeof(float), 0);
+    bm.shaking = shaking;
 }
 
 void updateMusic(GameState& gs) {
@@ -897,13 +528,22 @@ float getTextSize(const GameState& gs) {
     return sz;
 }
 
-void drawText(const GameState& gs, const std::string txt, Vector2 pos, Color col = WHITE) {
+// Laid out once per (text, size, colour) and then taken from gs.tmp.texts
+const TextLayout& getTextLayout(const GameState& gs, std::string_view txt, Color col) {
+    return gs.tmp.texts.get(gs.ga.p->font, txt, getTextSize(gs), col, 1.0f);
+}
+
+Vector2 measureText(const GameState& gs, std::string_view txt, Color col = WHITE) {
+    return getTextLayout(gs, txt, col).size;
+}
+
+void drawText(const GameState& gs, std::string_view txt, Vector2 pos, Color col = WHITE) {
     pos = {(float)int(pos.x), (float)int(pos.y)};
     auto pos2 = Vector2{pos.x, (float)int(pos.y + ceil(TILE_PIXEL))};
-    auto sz = getTextSize(gs);
+    const auto& layout = getTextLayout(gs, txt, col);
     Color darkol = Color{uint8_t(col.r * 0.6f), uint8_t(col.g * 0.6f), uint8_t(col.b * 0.6f), 255};
-    DrawTextEx(gs.ga.p->font, txt.c_str(), pos2, sz, 1.0, darkol);
-    DrawTextEx(gs.ga.p->font, txt.c_str(), pos, sz, 1.0, col);
+    drawTextLayout(gs.ga.p->font, layout, pos2, darkol);
+    drawTextLayout(gs.ga.p->font, layout, pos, col);
 }
 
 void drawTile(const GameState& gs, const ThingPos& tpos, Vector2 pos, Color col = WHITE, Vector2 sz = {TILE_SIZE, TILE_SIZE}) {
@@ -911,25 +551,14 @@ void drawTile(const GameState& gs, const ThingPos& tpos, Vector2 pos, Color col
     DrawTexturePro(gs.ga.p->tiles, {tpos.col * TILE_SIZE, tpos.row * TILE_SIZE, sz.x, sz.y}, {pos.x, pos.y, (float)int(sz.x * TILE_PIXEL), (float)int(sz.y * TILE_PIXEL)}, {0, 0}, 0, col);
 }
 
-void drawThing(const GameState& gs, Vector2 pos, const Thing& thing, bool masked = false, ThingPos maskTilePos = {}, uint8_t maskId1 = 0, uint8_t maskId2 = 0) {
-
-    if (masked) {
-        (*((GameState*)(&gs))).tmp.shMaskTilePos = Vector2{float(maskTilePos.col + maskId1), float(maskTilePos.row)};
-        (*((GameState*)(&gs))).tmp.shMaskId = maskId2;
-        SetShaderValue(gs.ga.p->maskFragShader, GetShaderLocation(gs.ga.p->maskFragShader, "maskTilePos"), &gs.tmp.shMaskTilePos, SHADER_UNIFORM_VEC2);
-        SetShaderValue(gs.ga.p->maskFragShader, GetShaderLocation(gs.ga.p->maskFragShader, "maskId"), &gs.tmp.shMaskId, SHADER_UNIFORM_INT);
-        BeginShaderMode(gs.ga.p->maskFragShader);
-        rlEnableShader(gs.ga.p->maskFragShader.id);
-        rlSetUniformSampler(GetShaderLocation(gs.ga.p->maskFragShader, "tiles"), gs.ga.p->tiles.id);
-    }
-
-    if (thing.bomb)
-        drawTile(gs, {4, thing.triggered ? ((int(floor(getTime(gs) * 20)) % 2 == 0) ? 4 : 5) : 3}, pos);
-    else
-        drawTile(gs, {0, (gs.usr.n_params == 1) ? 0 : thing.shp}, pos, COLORS[thing.clr], {TILE_SIZE, TILE_SIZE + 1.0f});
-
-    if (masked) {
-        EndShaderMode();
+// `alpha` is the tint alpha, which the mask shader reads as the shard to keep (see getMaskAlpha)
+void drawThing(const GameState& gs, Vector2 pos, const Thing& thing, unsigned char alpha = 255) {
+    if (thing.bomb) {
+        drawTile(gs, {4, thing.triggered ? ((int(floor(getTime(gs) * 20)) % 2 == 0) ? 4 : 5) : 3}, pos, {255, 255, 255, alpha});
+    } else {
+        Color col = COLORS[thing.clr];
+        col.a = alpha;
+        drawTile(gs, {0, (gs.usr.n_params == 1) ? 0 : thing.shp}, pos, col, {TILE_SIZE, TILE_SIZE + 1.0f});
     }
 
     //if (gs.usr.n_params >= 3)
@@ -939,6 +568,7 @@ void drawThing(const GameState& gs, Vector2 pos, const Thing& thing, bool masked
 }
 
 void drawAnimations(const GameState& gs) {
+    PROF_ZONE(DRAW_ANIMATIONS);
     for (int i = 0; i < gs.tmp.animations.count(); ++i) {
         auto& anim = gs.tmp.animations.get(i);
         if (!anim.done) {
@@ -950,6 +580,7 @@ void drawAnimations(const GameState& gs) {
 }
 
 void drawScorePoints(const GameState& gs) {
+    PROF_ZONE(DRAW_SCORE);
     for (int i = gs.tmp.scorePoints.count() - 1; i >= 0; --i) {
         auto& sp = gs.tmp.scorePoints.get(i);
         if (!sp.done) {
@@ -960,31 +591,225 @@ void drawScorePoints(const GameState& gs) {
     }
 }
 
+// 255 for a whole tile, else 254 - (mask tile column * 5 + shard); the row is the maskRow uniform
+unsigned char getMaskAlpha(const ParticleLook& look) {
+    if (!look.masked)
+        return 255;
+    return 254 - ((look.maskTilesStartPos.col + look.maskId1) * 5 + look.maskId2);
+}
+
+// One shader switch for all of them: the shard each one keeps rides in its vertex alpha,
+// and the mask row only changes, with a flush, between shards from different rows
 void drawParticles(const GameState& gs) {
-    for (int i = gs.tmp.particles.count() - 1; i >= 0; --i) {
-        auto& prt = gs.tmp.particles.get(i);
-        if (prt.exists) {
-            drawThing(gs, prt.pos, prt.thing, prt.masked, prt.maskTilesStartPos, prt.maskId1, prt.maskId2);
+    PROF_ZONE(DRAW_PARTICLES);
+    const auto& ga = *gs.ga.p;
+    const auto& prts = gs.tmp.particles;
+    BeginShaderMode(ga.maskFragShader);
+    int row = -1;
+    for (int i = prts.count() - 1; i >= 0; --i) {
+        const auto& look = prts.look(i);
+        if (look.masked && look.maskTilesStartPos.row != row) {
+            if (row >= 0)
+                rlDrawRenderBatchActive();
+            row = look.maskTilesStartPos.row;
+            ga.maskRow.set(ga.maskFragShader, (float)row);
+        }
+        drawThing(gs, {prts.x(i), prts.y(i)}, look.thing, getMaskAlpha(look));
+    }
+    EndShaderMode();
+}
+
+// GPU buffers for MAX_AIM_DOTS dots, uploaded once with the fan indices that never change
+void loadAimMesh(AimMesh& am) {
+    constexpr int VERTS = AIM_DOT_SIDES + 1;
+    am.vertices.assign(MAX_AIM_DOTS * VERTS * 3, 0.0f);
+    am.colors.assign(MAX_AIM_DOTS * VERTS * 4, 0);
+    am.indices.resize(MAX_AIM_DOTS * AIM_DOT_SIDES * 3);
+    for (int d = 0; d < MAX_AIM_DOTS; ++d) {
+        unsigned short c = d * VERTS;
+        for (int k = 0; k < AIM_DOT_SIDES; ++k) {
+            // Same winding as DrawCircleV: centre, next rim point, this rim point
+            unsigned short* tri = &am.indices[(d * AIM_DOT_SIDES + k) * 3];
+            tri[0] = c;
+            tri[1] = c + 1 + (k + 1) % AIM_DOT_SIDES;
+            tri[2] = c + 1 + k;
+        }
+    }
+    am.mesh.vertexCount = MAX_AIM_DOTS * VERTS;
+    am.mesh.triangleCount = MAX_AIM_DOTS * AIM_DOT_SIDES;
+    am.mesh.vertices = am.vertices.data();
+    am.mesh.colors = am.colors.data();
+    am.mesh.indices = am.indices.data();
+    UploadMesh(&am.mesh, true);
+    am.mesh.vertexCount = am.mesh.triangleCount = 0;
+}
+
+// Dots AIM_DOT_STEP apart along the traced path, from one step past the muzzle to where it stops
+void buildAimMesh(GameState& gs) {
+    auto& am = gs.tmp.aimMesh;
+    traceAim(gs, am.path);
+    Color col = COMBO_COLORS[gs.combo - 1];
+    Vector2 rim[AIM_DOT_SIDES];
+    for (int k = 0; k < AIM_DOT_SIDES; ++k)
+        rim[k] = TILE_PIXEL * Vector2{cosf(2.0f * PI * k / AIM_DOT_SIDES), sinf(2.0f * PI * k / AIM_DOT_SIDES)};
+    int dots = 0;
+    auto addDot = [&](Vector2 center) {
+        int v = dots++ * (AIM_DOT_SIDES + 1);
+        for (int k = 0; k <= AIM_DOT_SIDES; ++k, ++v) {
+            Vector2 p = k ? center + rim[k - 1] : center;
+            am.vertices[v * 3] = p.x;
+            am.vertices[v * 3 + 1] = p.y;
+            am.colors[v * 4] = col.r;
+            am.colors[v * 4 + 1] = col.g;
+            am.colors[v * 4 + 2] = col.b;
+            am.colors[v * 4 + 3] = col.a;
         }
+    };
+    float along = AIM_DOT_STEP;
+    for (int leg = 1; leg < am.path.count && dots < MAX_AIM_DOTS; ++leg) {
+        Vector2 a = am.path.points[leg - 1], b = am.path.points[leg];
+        float len = Vector2Distance(a, b);
+        for (; along <= len && dots < MAX_AIM_DOTS; along += AIM_DOT_STEP)
+            addDot(Vector2Lerp(a, b, along / len));
+        along -= len;
+    }
+    int verts = dots * (AIM_DOT_SIDES + 1);
+    if (verts) {
+        UpdateMeshBuffer(am.mesh, 0, am.vertices.data(), verts * 3 * sizeof(float), 0);
+        UpdateMeshBuffer(am.mesh, 3, am.colors.data(), verts * 4, 0);
+    }
+    am.mesh.vertexCount = verts;
+    am.mesh.triangleCount = dots * AIM_DOT_SIDES;
+    am.dirty = false;
+}
+
+// Retraces the aim guide only when the gun turned, a tile changed, the board moved
+// by a whole pixel, the screen was resized or the combo colour changed
+void updateAimMesh(GameState& gs) {
+    PROF_ZONE(EFFECTS);
+    auto& am = gs.tmp.aimMesh;
+    if (!am.mesh.vboId)
+        loadAimMesh(am);
+    auto brect = getBoardRect(gs);
+    AimKey key = {gs.gun.dir, gs.board.version, floorf(brect.x), floorf(brect.y), gs.tmp.frame.width, gs.tmp.frame.height, gs.combo};
+    if (am.dirty || !(key == am.key)) {
+        am.key = key;
+        buildAimMesh(gs);
     }
 }
 
-void drawBoard(const GameState& gs) {
-    for (int i = 0; i < BOARD_HEIGHT; ++i) {
-        for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j) {
-            const Tile& tile = gs.board.things[i][j];
-            if (tile.exists) {
-                Vector2 tpos = getPixByPos(gs, {i, j});
-                Vector2 shake = SHAKE_STR * RAND_FLOAT_SIGNED_2D * (
-                        gs.gameOver ?
-                        std::clamp((getTime(gs) - gs.gameOverTime)/std::max((GAME_OVER_TIME_PER_ROW * (BOARD_HEIGHT - 1 - i)), 0.001f), 0.0, 1.0) :
-                        tile.shake
-                );
-                drawThing(gs, tpos + shake, tile.thing);
+void drawAim(const GameState& gs) {
+    const auto& am = gs.tmp.aimMesh;
+    if (!am.mesh.triangleCount)
+        return;
+    rlDrawRenderBatchActive();
+    DrawMesh(am.mesh, gs.ga.p->aimMaterial, MatrixIdentity());
+}
+
+// GPU buffers for the grid; positions and texcoords come with the first update
+void loadRippleGrid(GameState& gs, RippleGrid& rg) {
+    constexpr int COLS = RIPPLE_GRID_COLS + 1, ROWS = RIPPLE_GRID_ROWS + 1;
+    rg.vertices.assign(COLS * ROWS * 3, 0.0f);
+    rg.texcoords.assign(COLS * ROWS * 2, 0.0f);
+    rg.indices.resize(RIPPLE_GRID_COLS * RIPPLE_GRID_ROWS * 6);
+    for (int r = 0; r < RIPPLE_GRID_ROWS; ++r) {
+        for (int c = 0; c < RIPPLE_GRID_COLS; ++c) {
+            // Same corner order as the board's quads: top-left, bottom-left, bottom-right, top-right
+            unsigned short tl = r * COLS + c, bl = tl + COLS, br = bl + 1, tr = tl + 1;
+            unsigned short quad[6] = {tl, bl, br, tl, br, tr};
+            std::copy(quad, quad + 6, &rg.indices[(r * RIPPLE_GRID_COLS + c) * 6]);
+        }
+    }
+    rg.mesh.vertexCount = COLS * ROWS;
+    rg.mesh.triangleCount = RIPPLE_GRID_COLS * RIPPLE_GRID_ROWS * 2;
+    rg.mesh.vertices = rg.vertices.data();
+    rg.mesh.texcoords = rg.texcoords.data();
+    rg.mesh.indices = rg.indices.data();
+    UploadMesh(&rg.mesh, true);
+    rg.material = LoadMaterialDefault();
+    rg.material.shader = gs.ga.p->postProcFragShader;
+    rg.width = rg.height = 0;
+    rg.texSpan = Vector2Zero();
+    rg.displaced = false;
+}
+
+// Drops the faded shockwaves and offsets the grid's texcoords by the live ones; distances
+// are in board widths and the offsets in UV units, as the old per-pixel shader had them
+void updateRippleGrid(GameState& gs) {
+    constexpr int COLS = RIPPLE_GRID_COLS + 1, ROWS = RIPPLE_GRID_ROWS + 1;
+    auto& rg = gs.tmp.rippleGrid;
+    if (!rg.mesh.vboId)
+        loadRippleGrid(gs, rg);
+    float w = GetScreenWidth(), h = GetScreenHeight();
+    // Screen pixels renderTex covers, a little more than the screen when its size
+    // doesn't divide by renderScale
+    Vector2 span = {float(gs.tmp.renderTex.texture.width * gs.tmp.renderScale), float(gs.tmp.renderTex.texture.height * gs.tmp.renderScale)};
+    bool resized = (w != rg.width || h != rg.height || span.x != rg.texSpan.x || span.y != rg.texSpan.y);
+    if (resized) {
+        for (int r = 0; r < ROWS; ++r) {
+            for (int c = 0; c < COLS; ++c) {
+                rg.vertices[(r * COLS + c) * 3] = w * c / RIPPLE_GRID_COLS;
+                rg.vertices[(r * COLS + c) * 3 + 1] = h * r / RIPPLE_GRID_ROWS;
             }
         }
+        UpdateMeshBuffer(rg.mesh, 0, rg.vertices.data(), COLS * ROWS * 3 * sizeof(float), 0);
+        rg.width = w;
+        rg.height = h;
+        rg.texSpan = span;
     }
+
+    checkDrops(gs);
+    const auto& waves = gs.tmp.shockwaves;
+    int nActive = waves.count();
+    float ages[MAX_SHOCKWAVES];
+    for (int i = 0; i < nActive; ++i)
+        ages[i] = getTime(gs) - waves.get(i).startTime;
+    if (!nActive && !rg.displaced && !resized)
+        return;
+    float bWidth = getBoardRect(gs).width;
+    // Past this many board widths a wave moves no vertex by half a texel or more
+    float reach = logf(2.0f * WAVE_AMPLITUDE * bWidth / gs.tmp.renderScale) / WAVE_DIST_FADE;
+    for (int r = 0; r < ROWS; ++r) {
+        for (int c = 0; c < COLS; ++c) {
+            Vector2 pix = {w * c / RIPPLE_GRID_COLS, h * r / RIPPLE_GRID_ROWS};
+            // renderTex is upside down, so the top row samples v = 1
+            Vector2 uv = {pix.x / span.x, 1.0f - pix.y / span.y};
+            for (int i = 0; i < nActive; ++i) {
+                float t = ages[i];
+                Vector2 center = waves.get(i).center;
+                // Up on screen is up in UV, hence the flipped y
+                Vector2 delta = Vector2{pix.x - center.x, center.y - pix.y} / bWidth;
+                float dist = Vector2Length(delta);
+                // Skip before the trig where the wave isn't: not reached yet, faded out
+                // behind its front, or too weak this far out
+                if (dist == 0 || t * WAVE_SPEED <= dist || t - dist >= WAVE_FRONT_FADE || dist > reach)
+                    continue;
+                float amplitude = WAVE_AMPLITUDE * (1.0f - std::clamp((t - dist) / WAVE_FRONT_FADE, 0.0f, 1.0f)) * (bWidth / span.x);
+                float wave = sinf(dist * WAVE_FREQUENCY - t * WAVE_SPEED) * amplitude;
+                float front = std::clamp(t * WAVE_SPEED - dist, 0.0f, 1.0f);
+                float mask = front * front * (3.0f - 2.0f * front);
+                uv += delta * (wave * mask * expf(-dist * WAVE_DIST_FADE) / dist);
+            }
+            rg.texcoords[(r * COLS + c) * 2] = uv.x;
+            rg.texcoords[(r * COLS + c) * 2 + 1] = uv.y;
+        }
+    }
+    UpdateMeshBuffer(rg.mesh, 1, rg.texcoords.data(), COLS * ROWS * 2 * sizeof(float), 0);
+    rg.displaced = (nActive > 0);
+}
+
+void drawBoard(const GameState& gs) {
+    PROF_ZONE(DRAW_BOARD);
+    const auto& ga = *gs.ga.p;
+    const auto& bm = gs.tmp.boardMesh;
     auto brect = getBoardRect(gs);
+    if (bm.mesh.triangleCount) {
+        rlDrawRenderBatchActive();
+        ga.board.boardOffset.set(ga.boardShader, {brect.x, brect.y});
+        ga.board.shakeSeed.set(ga.boardShader, RAND_FLOAT * 100.0f);
+        ga.board.shakeStr.set(ga.boardShader, qualityTier(gs).shakeNoise ? SHAKE_STR : 0.0f);
+        DrawMesh(bm.mesh, ga.boardMaterial, MatrixIdentity());
+    }
     DrawRectangleRec({brect.x - 3.0f, 0.0f, 3.0f, (float)GetScreenHeight()}, WHITE);
     DrawRectangleRec({brect.x + brect.width, 0.0f, 3.0f, (float)GetScreenHeight()}, WHITE);
 
@@ -995,25 +820,27 @@ void drawBoard(const GameState& gs) {
 }
 
 void drawBullet(const GameState& gs) {
+    PROF_ZONE(DRAW_BULLET);
     drawThing(gs, gs.bullet.pos, gs.bullet.thing);
 }
 
 void drawGameOver(const GameState& gs) {
+    PROF_ZONE(DRAW_GAME_OVER);
     float coeff = easeOutBounce(1.0f - std::clamp((gs.gameOverTime + GAME_OVER_TIMEOUT - getTime(gs))/GAME_OVER_TIMEOUT_BEF, 0.0, 1.0));
     auto brec = getBoardRect(gs);
     Vector2 skulpos = {brec.x + brec.width * 0.5f, GetScreenHeight() * -0.25f + coeff * GetScreenHeight() * 0.5f};
     drawTile(gs, {2, ((int(floor(getTime(gs) * 10)) % 2 == 0) ? 5 : (gs.alteredDifficulty ? 9 : ((gs.score == 0) ? 8 : ((gs.usr.bestScore == gs.score) ? 7 : 6))))}, skulpos);
-    auto verdictstr = (gs.usr.bestScore == gs.score && !gs.alteredDifficulty) ? ((gs.usr.bestScore > 0) ? std::string("NEW RECORD!") : std::string("Really now???")) : ("Best: " + std::to_string(gs.usr.bestScore));
-    auto sz = getTextSize(gs);
-    auto vmeas = MeasureTextEx(gs.ga.p->font, verdictstr.c_str(), sz, 1.0);
+    // TextFormat's buffers are reused after a few calls: every string here is used before that
+    const char* verdictstr = (gs.usr.bestScore == gs.score && !gs.alteredDifficulty) ? ((gs.usr.bestScore > 0) ? "NEW RECORD!" : "Really now???") : TextFormat("Best: %d", gs.usr.bestScore);
+    auto vmeas = measureText(gs, verdictstr, WHITE);
     drawText(gs, verdictstr, skulpos + Vector2{-vmeas.x * 0.5f, TILE_RADIUS * 3.0f - vmeas.y * 0.5f}, WHITE);
 
-    auto scorestr = gs.alteredDifficulty ? ("\"" + std::to_string(gs.score) + "\"") : std::to_string(gs.score);
-    auto meas = MeasureTextEx(gs.ga.p->font, scorestr.c_str(), sz, 1.0);
+    const char* scorestr = TextFormat(gs.alteredDifficulty ? "\"%d\"" : "%d", gs.score);
+    auto meas = measureText(gs, scorestr, PINK);
     auto txtPos1prv = Vector2{TILE_RADIUS * 2.0f + brec.x - TILE_RADIUS * 0.5f + (brec.width - TILE_RADIUS * 6.0f) * 0.25f - meas.x * 0.5f, GetScreenHeight() - TILE_RADIUS - meas.y * 0.5f};
-    auto scorestr2 = "x" + std::to_string(gs.combo);
+    const char* scorestr2 = TextFormat("x%d", gs.combo);
     auto txtPosnew = Vector2{brec.x + brec.width * 0.5f - meas.x * 0.5f, GetScreenHeight() * 0.5f - meas.y * 0.5f};
-    meas = MeasureTextEx(gs.ga.p->font, scorestr2.c_str(), getTextSize(gs), 1.0);
+    meas = measureText(gs, scorestr2, COMBO_COLORS[gs.combo - 1]);
     auto txtPos2prv = Vector2{brec.x + brec.width - TILE_RADIUS * 1.5f - (brec.width - TILE_RADIUS * 6.0f) * 0.25f - meas.x * 0.5f, GetScreenHeight() - TILE_RADIUS - meas.y * 0.5f};
 
     drawText(gs, scorestr, txtPos1prv + (txtPosnew - txtPos1prv) * coeff, PINK);
@@ -1024,6 +851,7 @@ void drawGameOver(const GameState& gs) {
 
 void drawBottom(const GameState& gs)
 {
+    PROF_ZONE(DRAW_BOTTOM);
     float startCoeff = easeOutQuad(std::clamp((getTime(gs) - gs.gameStartTime)/GAME_START_TIME, 0.0, 1.0));
 
     auto brec = getBoardRect(gs);
@@ -1042,16 +870,8 @@ void drawBottom(const GameState& gs)
 
     if (!gs.gameOver) {
 
-        if (gs.gameStartTime + GAME_START_TIME < getTime(gs)) {
-            const int NTICKS = 50;
-            const float TICKSTEP = TILE_RADIUS * 2;
-            Vector2 pos = gunPos;
-            float dir = gs.gun.dir + PI * 0.5f;
-            for (int i = 0; i < NTICKS; ++i) {
-                pos += TICKSTEP * Vector2{cos(dir), -sin(dir)};
-                DrawCircleV(pos, TILE_PIXEL, COMBO_COLORS[gs.combo - 1]);
-            }
-        }
+        if (gs.gameStartTime + GAME_START_TIME < getTime(gs))
+            drawAim(gs);
         auto pt = GetSplinePointBezierQuad(nextPos, (nextPos + gunPos) * 0.5f - Vector2{0, 2.0f * TILE_RADIUS}, gunPos, rearmCoeff);
         auto pt2 = GetSplinePointBezierQuad(extraPos, (extraPos + gunPos) * 0.5f + Vector2{0, -2.0f * TILE_RADIUS}, gunPos, swapCoeff);
         drawThing(gs, (swapCoeff == 1.0f || gs.gun.firstSwap) ? pt : pt2, gs.gun.armed);
@@ -1060,11 +880,11 @@ void drawBottom(const GameState& gs)
 
         if (gs.gun.extraArmed)
             drawThing(gs, gunPos + (extraPos - gunPos) * swapCoeff, gs.gun.extra);
-        auto scorestr = gs.alteredDifficulty ? ("\"" + std::to_string(gs.tmp.visScore) + "\"") : std::to_string(gs.tmp.visScore);
-        auto meas = MeasureTextEx(gs.ga.p->font, scorestr.c_str(), getTextSize(gs), 1.0);
+        const char* scorestr = TextFormat(gs.alteredDifficulty ? "\"%d\"" : "%d", gs.tmp.visScore);
+        auto meas = measureText(gs, scorestr, PINK);
         drawText(gs, scorestr, {TILE_RADIUS * 2.0f + brec.x - TILE_RADIUS * 0.5f + (brec.width - TILE_RADIUS * 6.0f) * 0.25f - meas.x * 0.5f - (1.0f - startCoeff) * TILE_RADIUS * 2.0f, GetScreenHeight() - TILE_RADIUS - meas.y * 0.5f + (1.0f - startCoeff) * TILE_RADIUS * 2.0f}, PINK);
-        auto scorestr2 = "x" + std::to_string(gs.combo);
-        meas = MeasureTextEx(gs.ga.p->font, scorestr2.c_str(), getTextSize(gs), 1.0);
+        const char* scorestr2 = TextFormat("x%d", gs.combo);
+        meas = measureText(gs, scorestr2, COMBO_COLORS[gs.combo - 1]);
         drawText(gs, scorestr2, {brec.x + brec.width - TILE_RADIUS * 1.5f - (brec.width - TILE_RADIUS * 6.0f) * 0.25f - meas.x * 0.5f + (1.0f - startCoeff) * TILE_RADIUS * 2.0f, GetScreenHeight() - TILE_RADIUS - meas.y * 0.5f + (1.0f - startCoeff) * TILE_RADIUS * 2.0f}, COMBO_COLORS[gs.combo - 1]);
 
         bool warning = false;
@@ -1122,6 +942,7 @@ void draw(const GameState& gs) {
 
 void updateAndDrawSettings(GameState& gs)
 {
+    PROF_ZONE(DRAW_SETTINGS);
     auto prvusr = gs.usr;
 
     updateMusic(gs);
@@ -1164,76 +985,159 @@ void updateAndDrawSettings(GameState& gs)
     drawSettingsButton(gs);
 }
 
+#ifdef HEHEX_PROFILE
+// F3 or a three finger tap shows the zone timings, F4 or four fingers saves the trace
+void updateProfiler() {
+    static int touchCount = 0;
+    int touches = GetTouchPointCount();
+    auto& prof = getProfiler();
+    if (IsKeyPressed(KEY_F3) || (touches == 3 && touchCount < 3))
+        prof.overlay = !prof.overlay;
+    if (IsKeyPressed(KEY_F4) || (touches == 4 && touchCount < 4))
+        SaveFileText("profile.csv", (char*)prof.csv().c_str());
+    touchCount = touches;
+}
+
+void drawProfiler(const GameState& gs) {
+    const auto& prof = getProfiler();
+    if (!prof.overlay)
+        return;
+    int fontSize = std::max(10, GetScreenHeight() / 60);
+    DrawRectangle(0, 0, fontSize * 22, fontSize * ((int)ProfZone::COUNT + 3), Fade(BLACK, 0.6f));
+    DrawText(TextFormat("%-14s %6s %6s %6s", "ms", "last", "avg", "peak"), fontSize / 2, fontSize / 2, fontSize, WHITE);
+    for (int i = 0; i < (int)ProfZone::COUNT; ++i) {
+        auto zone = (ProfZone)i;
+        DrawText(TextFormat("%-14s %6.2f %6.2f %6.2f", PROF_ZONE_NAMES[i], prof.last(zone), prof.average(zone), prof.peak(zone)),
+            fontSize / 2, fontSize / 2 + (i + 1) * fontSize, fontSize, (prof.last(zone) > 1000.0f / 60.0f) ? RED : WHITE);
+    }
+    const auto& q = gs.tmp.quality;
+    DrawText(TextFormat("quality tier %d  load %.2f  scale %d", q.tier, q.load, gs.tmp.renderScale),
+        fontSize / 2, fontSize / 2 + ((int)ProfZone::COUNT + 1) * fontSize, fontSize, q.tier ? YELLOW : WHITE);
+}
+#endif
+
+// Keys the game reads as presses; checked with IsKeyPressed, which leaves raylib's key queue alone
+constexpr KeyboardKey INPUT_KEYS[] = {KEY_SPACE, KEY_LEFT_CONTROL, KEY_Q, KEY_Z, KEY_ESCAPE, KEY_F3, KEY_F4};
+
+bool hasInput() {
+    for (auto key : INPUT_KEYS)
+        if (IsKeyPressed(key))
+            return true;
+    return GetTouchPointCount() > 0 || IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_RIGHT)
+        || IsMouseButtonDown(MOUSE_BUTTON_LEFT) || IsMouseButtonDown(MOUSE_BUTTON_RIGHT) || IsMouseButtonDown(MOUSE_BUTTON_MIDDLE)
+        || IsMouseButtonReleased(MOUSE_BUTTON_LEFT) || GetMouseDelta().x != 0 || GetMouseDelta().y != 0;
+}
+
+// Something moves every frame: input, effects, a flying bullet or a timed transition
+bool isAnimating(const GameState& gs) {
+    auto t = getTime(gs);
+    return hasInput() || IsWindowResized() || gs.bullet.exists
+        || gs.tmp.particles.count() || gs.tmp.animations.count() || gs.tmp.scorePoints.count() || gs.tmp.shockwaves.count()
+        || gs.tmp.boardMesh.shaking || (gs.tmp.visScore != gs.score)
+        || t - gs.gameStartTime < GAME_START_TIME || t - gs.rearmTime < REARM_TIMEOUT || t - gs.swapTime < REARM_TIMEOUT
+        || (gs.gameOver && t - gs.gameOverTime < GAME_OVER_TIMEOUT);
+}
+
+// Whether this frame can differ from the one already in renderTex. Also drops to
+// IDLE_FPS after IDLE_AFTER_FRAMES frames in which nothing but the blink phase
+// changed, and back on the next one.
+bool needsRedraw(GameState& gs) {
+    int tick = int(floor(getTime(gs) * (gs.tmp.boardMesh.flashing ? 20 : 10)));
+    SceneKey key = {IsWindowFocused(), gs.settingsOpened, gs.gameOver, gs.board.version, gs.board.pos, gs.settingsOpened ? 0 : tick};
+    SceneKey still = key;
+    still.tick = gs.tmp.scene.tick;
+    bool moving = isAnimating(gs) || !gs.tmp.sceneDrawn || !(still == gs.tmp.scene);
+    bool redraw = moving || key.tick != gs.tmp.scene.tick;
+    gs.tmp.scene = key;
+    gs.tmp.sceneDrawn = true;
+
+    gs.tmp.idleFrames = moving ? 0 : gs.tmp.idleFrames + 1;
+    int fps = (gs.tmp.idleFrames > IDLE_AFTER_FRAMES) ? IDLE_FPS : TARGET_FPS;
+    if (fps != gs.tmp.targetFps) {
+        gs.tmp.targetFps = fps;
+        SetTargetFPS(fps);
+    }
+    return redraw;
+}
+
 DLL_EXPORT void updateAndDraw(GameState& gs)
 {
+    PROF_END_FRAME();
+    PROF_ZONE(FRAME);
+
     if (!gs.tmp.timeOffsetSet) {
         if (gs.time == 0) gs.time = GetTime();
         gs.tmp.timeOffset = gs.time - GetTime();
         gs.tmp.timeOffsetSet = true;
     }
 
-    if (!gs.usr.velEnabled || !gs.usr.accEnabled || (gs.usr.n_params == 1))
-        gs.alteredDifficulty = true;
-    else if (!gs.firstShotFired) {
-        gs.alteredDifficulty = false;
-    }
-
     if (IsWindowResized()) {
-        auto rt = RenderTexture{};
-        setStuff(gs.ga.p, rt, gs);
+        setStuff(gs.ga.p, gs.tmp.renderTex, gs);
+        gs.tmp.sceneDrawn = false;
     }
 
-    BeginTextureMode(gs.tmp.renderTex);
-    ClearBackground(BLACK);
+    auto frame = getSimFrame(gs);
+    setFrame(gs, frame);
+    updateRenderTex(gs);
+    updateQuality(gs);
+
     if (gs.settingsOpened) {
-        updateAndDrawSettings(gs);
+        if (needsRedraw(gs)) {
+            beginScene(gs);
+            updateAndDrawSettings(gs);
+            endScene();
+        } else {
+            updateMusic(gs);
+        }
     } else {
         updateSettingsButton(gs);
         if (IsWindowFocused()) {
-            if (gs.inputTimeoutTime == 0)
-                gs.inputTimeoutTime = getTime(gs);
-            if (getTime(gs) - gs.inputTimeoutTime > INPUT_TIMEOUT && getFrameTime(gs) < 1.0) {
-                for (int i = 0; i < UPDATE_ITS; ++i)
-                    update(gs);
-                updateOnce(gs);
-            }
+            simStep(gs, readInput(gs), frame);
+            applySimEvents(gs);
             flyParticles(gs);
             flyScorePoints(gs);
-            checkDrops(gs);
             checkAnimations(gs);
+            updateBoardMesh(gs);
+            updateAimMesh(gs);
             updateMusic(gs);
         } else  {
             gs.inputTimeoutTime = 0;
         }
-        draw(gs);
-        drawSettingsButton(gs);
+        if (needsRedraw(gs)) {
+            beginScene(gs);
+            draw(gs);
+            drawSettingsButton(gs);
+            endScene();
+        }
     }
-    EndTextureMode();
 
     if (IsMouseButtonPressed(MOUSE_BUTTON_MIDDLE))
         addDrop(gs, GetMousePosition());
 
-    gs.tmp.shTime = getTime(gs);
-    gs.tmp.shScreenSize = {(float)GetScreenWidth(), (float)GetScreenHeight()};
-    gs.tmp.shBWidth = getBoardRect(gs).width;
-    SetShaderValue(gs.ga.p->postProcFragShader, GetShaderLocation(gs.ga.p->postProcFragShader, "time"), &gs.tmp.shTime, SHADER_UNIFORM_FLOAT);
-    SetShaderValue(gs.ga.p->postProcFragShader, GetShaderLocation(gs.ga.p->postProcFragShader, "screenSize"), &gs.tmp.shScreenSize, SHADER_UNIFORM_VEC2);
-    SetShaderValue(gs.ga.p->postProcFragShader, GetShaderLocation(gs.ga.p->postProcFragShader, "bWidth"), &gs.tmp.shBWidth, SHADER_UNIFORM_FLOAT);
-    SetShaderValue(gs.ga.p->postProcFragShader, GetShaderLocation(gs.ga.p->postProcFragShader, "nDrops"), &gs.tmp.shNDrops, SHADER_UNIFORM_INT);
-    if (gs.tmp.shNDrops) {
-        SetShaderValueV(gs.ga.p->postProcFragShader, GetShaderLocation(gs.ga.p->postProcFragShader, "dropTimes"), gs.tmp.shDropTimes.data(), SHADER_UNIFORM_FLOAT, gs.tmp.shNDrops);
-        SetShaderValueV(gs.ga.p->postProcFragShader, GetShaderLocation(gs.ga.p->postProcFragShader, "dropCenters"), gs.tmp.shDropCenters.data(), SHADER_UNIFORM_VEC2, gs.tmp.shNDrops);
-    }
+#ifdef HEHEX_PROFILE
+    updateProfiler();
+#endif
 
-    BeginDrawing();
-    if (IsRenderTextureValid(gs.tmp.renderTex)) {
-        BeginShaderMode(gs.ga.p->postProcFragShader);
-        DrawTextureRec(gs.tmp.renderTex.texture, Rectangle{0, 0, (float)gs.tmp.renderTex.texture.width, (float)-gs.tmp.renderTex.texture.height}, Vector2Zero(), WHITE);
-        EndShaderMode();
-    } else {
-        ClearBackground(BLACK);
+    {
+        PROF_ZONE(POST_PROCESS);
+        updateRippleGrid(gs);
+
+        BeginDrawing();
+        if (IsRenderTextureValid(gs.tmp.renderTex)) {
+            auto& rg = gs.tmp.rippleGrid;
+            rg.material.maps[MATERIAL_MAP_DIFFUSE].texture = gs.tmp.renderTex.texture;
+            DrawMesh(rg.mesh, rg.material, MatrixIdentity());
+        } else {
+            ClearBackground(BLACK);
+        }
+    }
+#ifdef HEHEX_PROFILE
+    drawProfiler(gs);
+#endif
+    {
+        PROF_ZONE(END_DRAWING);
+        EndDrawing();
     }
-    EndDrawing();
 
     gs.time = GetTime();
 }
@@ -1,9 +1,17 @@
+#pragma once
+
 #include <array>
 #include <cstdint>
+#include <vector>
 
 #include "raylib.h"
 
 #include "util/arena.h"
+#include "util/gpu_mesh.h"
+#include "util/hex_bits.h"
+#include "util/particle_store.h"
+#include "util/shader_uniform.h"
+#include "util/text_cache.h"
 #include "raymath.h"
 #include "game_cfg.h"
 
@@ -13,10 +21,28 @@
 #define DO_NOT_SERIALIZE ;
 #endif
 
+using BoardBits = HexBits<BOARD_WIDTH, BOARD_HEIGHT>;
+
 struct ThingPos {
     int row, col;
 };
 
+struct PosIndex {
+    BoardBits bits;
+    void add(const ThingPos& pos) {bits.set(pos.row, pos.col);}
+    void remove(const ThingPos& pos) {bits.clear(pos.row, pos.col);}
+    void clear() {bits.clear();}
+    bool contains(const ThingPos& pos) const {return bits.test(pos.row, pos.col);}
+};
+
+using PosArena = FixedArena<MAX_TODROP, ThingPos, ArenaOverflow::DROP_NEWEST, PosIndex>;
+static_assert(arena_capacity_v<PosArena> >= BOARD_WIDTH * BOARD_HEIGHT, "a drop must fit the whole board");
+
+struct DropScratch {
+    PosArena todrops[3];
+    PosArena uncons[3];
+};
+
 struct Thing {
     unsigned char clr, shp, sym;
     bool bomb = false;
@@ -39,9 +65,10 @@ struct Board {
     std::array<std::array<Tile, BOARD_WIDTH>, BOARD_HEIGHT> things;
     bool even = false;
     double moveTime, totalMoveTime;
-    Arena<MAX_TODROP, ThingPos> todrop;
-    Arena<MAX_TODROP, ThingPos> uncon;
+    PosArena todrop;
+    PosArena uncon;
     uint8_t lastDropCombo = 1;
+    uint32_t version = 0;  // bumped on every tile change
 };
 
 struct Gun {
@@ -55,16 +82,12 @@ struct Gun {
     Thing next;
 };
 
-struct Particle {
-    bool exists = true;
+struct ParticleLook {
     Thing thing;
-    Vector2 pos = Vector2Zero();
-    Vector2 vel = Vector2Zero();
-    bool bounced = false;
     bool masked = false;
-    ThingPos maskTilesStartPos;
-    uint8_t maskId1;
-    uint8_t maskId2;
+    ThingPos maskTilesStartPos = {};
+    uint8_t maskId1 = 0;
+    uint8_t maskId2 = 0;
 };
 
 struct ScorePoint {
@@ -72,6 +95,7 @@ struct ScorePoint {
     double spawnTime, flyTime;
     Color col;
     bool done = false;
+    int value = 1;
 };
 
 struct Animation {
@@ -83,6 +107,11 @@ struct Animation {
     bool done = false;
 };
 
+struct Shockwave {
+    Vector2 center;
+    double startTime;
+};
+
 struct Bullet {
     bool exists = false;
     Thing thing;
@@ -91,10 +120,156 @@ struct Bullet {
     ThingPos lstEmp;
     bool rebouncing = false;
     float rebounce;
-    Vector2 rebCp, rebEnd;
+    Vector2 rebStart, rebCp, rebEnd;
     double rebTime;
 };
 
+struct AimPath {
+    std::array<Vector2, MAX_BULLET_LEGS + 1> points;
+    int count = 0;
+    bool hit = false;
+    ThingPos hitPos;
+};
+
+enum class SimSound : uint8_t {
+    CLANG, WHOOSH, SWAP, SIZZLE, EXPLOSION, SHATTER, FAIL, SHAKE
+};
+
+enum class SimAnim : uint8_t {
+    SPLASH, EXPLOSION
+};
+
+enum class SimEventType : uint8_t {
+    SOUND,      // id: SimSound
+    ANIMATION,  // id: SimAnim
+    PARTICLE,
+    SHATTER,    // id: first mask id
+    SCORE,
+    SHOCKWAVE,
+    RECORD,
+    RESET
+};
+
+struct SimEvent {
+    SimEventType type;
+    uint8_t id = 0;
+    Thing thing = {};
+    Vector2 pos = Vector2Zero();
+    Vector2 vel = Vector2Zero();
+    Color col = WHITE;
+    int n = 0;
+};
+
+struct SimFrame {
+    double time;
+    float delta;
+    float width, height;
+};
+
+struct Layout {
+    Rectangle board;
+    float tileRadius;
+    float rowHeight;
+    float tilePixel;
+    float bulletSpeed;
+};
+
+struct SceneKey {
+    bool focused = false;
+    bool settingsOpened = false;
+    bool gameOver = false;
+    uint32_t boardVersion = 0;
+    float boardPos = 0;
+    int tick = 0;  // blink phase
+    bool operator==(const SceneKey&) const = default;
+};
+
+struct SimInput {
+    bool aim = false;
+    Vector2 aimPos = Vector2Zero();
+    int turn = 0;  // 1 = left, -1 = right
+    bool fire = false;
+    bool swap = false;
+    bool restart = false;
+    bool cycleParams = false;
+    bool easeDifficulty = false;
+    bool editAdd = false;
+    bool editRemove = false;
+    Vector2 editPos = Vector2Zero();
+};
+
+struct BoardUniforms {
+    ShaderUniform<Vector2, SHADER_UNIFORM_VEC2> boardOffset;
+    ShaderUniform<float, SHADER_UNIFORM_FLOAT> shakeSeed;
+    ShaderUniform<float, SHADER_UNIFORM_FLOAT> shakeStr;
+};
+
+// One quad per tile, quad q at vertices 4q..4q+3; the vectors back the GpuMesh arrays
+struct BoardMesh {
+    GpuMesh mesh;
+    std::vector<float> vertices, texcoords, shake;
+    std::vector<unsigned char> colors;
+    std::vector<unsigned short> indices;
+    std::vector<ThingPos> quadTiles;
+    bool dirty = true;
+    bool shaking = false;
+    bool flashing = false;
+    int flashPhase = 0;
+    uint32_t version = 0;
+    int nParams = 0;
+    float tilePixel = 0;
+};
+
+struct AimKey {
+    float dir = 0;
+    uint32_t boardVersion = 0;
+    float boardX = 0, boardY = 0;
+    float width = 0, height = 0;
+    int combo = 0;
+    bool operator==(const AimKey&) const = default;
+};
+
+struct AimMesh {
+    GpuMesh mesh;
+    std::vector<float> vertices;
+    std::vector<unsigned char> colors;
+    std::vector<unsigned short> indices;
+    AimPath path;
+    AimKey key;
+    bool dirty = true;
+};
+
+struct RippleGrid {
+    GpuMesh mesh;
+    Material material = {};
+    std::vector<float> vertices, texcoords;
+    std::vector<unsigned short> indices;
+    float width = 0, height = 0;
+    Vector2 texSpan = Vector2Zero();
+    bool displaced = false;
+};
+
+struct QualityTier {
+    int shatterShards;  // of 5
+    int maxShockwaves;
+    int scorePerPoint;
+    bool shakeNoise;
+};
+
+inline constexpr QualityTier QUALITY_TIERS[] = {
+    {5, MAX_SHOCKWAVES, 1, true},
+    {3, 32, 2, true},
+    {2, 8, 4, false},
+    {1, 4, 8, false},
+};
+
+struct QualityGovernor {
+    int tier = 0;
+    float load = 1.0f;  // smoothed frame time / budget
+    float calmTime = 0;
+    float stepCooldown = 0;
+};
+
 struct GameAssets {
     Texture2D tiles;
     Texture2D explosion;
@@ -112,6 +287,11 @@ struct GameAssets {
     Sound beep;
     Shader postProcFragShader;
     Shader maskFragShader;
+    ShaderUniform<float, SHADER_UNIFORM_FLOAT> maskRow;
+    Shader boardShader;
+    Material boardMaterial;
+    BoardUniforms board;
+    Material aimMaterial;
 };
 
 struct GameState {
@@ -144,22 +324,28 @@ struct GameState {
     } usr;
     struct Temp {
         DO_NOT_SERIALIZE
-        Arena<MAX_PARTICLES, Particle> particles;
-        Arena<MAX_PARTICLES, Animation> animations;
-        Arena<MAX_PARTICLES, ScorePoint> scorePoints;
+        ParticleStore<MAX_FALLING_PARTICLES, ParticleLook> particles;
+        FixedArena<MAX_PARTICLES, Animation, ArenaOverflow::OVERWRITE_OLDEST> animations;
+        Arena<MAX_PARTICLES, ScorePoint, ArenaOverflow::GROW> scorePoints;
+        Arena<MAX_SIM_EVENTS, SimEvent> events;
+        DropScratch dropScratch;
+        GpuLocal<BoardMesh> boardMesh;
+        GpuLocal<AimMesh> aimMesh;
+        GpuLocal<RippleGrid> rippleGrid;
+        SceneKey scene;
+        bool sceneDrawn = false;
+        int idleFrames = 0;
+        int targetFps = TARGET_FPS;
+        QualityGovernor quality;
+        TextCache<MAX_CACHED_TEXTS> texts;
+        SimFrame frame;
+        Layout layout;
         bool timeOffsetSet = false;
         double timeOffset;
         int visScore = 0;
-        RenderTexture2D renderTex;
-        uint32_t shNDrops = 0;
-        float shTime;
-        float shFadeTime = WAVE_FADE_TIME;
-        Vector2 shScreenSize;
-        float shBWidth;
-        std::array<float, 128> shDropTimes;
-        std::array<Vector2, 128> shDropCenters;
-        Vector2 shMaskTilePos;
-        uint32_t shMaskId;
+        RenderTexture2D renderTex = {};
+        int renderScale = 1;
+        FixedArena<MAX_SHOCKWAVES, Shockwave, ArenaOverflow::OVERWRITE_OLDEST> shockwaves;
         double lastScoreSnd;
         double lastWarnSnd;
     } tmp;
@@ -174,5 +360,6 @@ extern "C" {
     void init(GameAssets& ga, GameState& gs);
     void setState(GameState& gs, const GameState& ngs);
     void updateAndDraw(GameState& gs);
+    void deinit(GameState& gs);
 }
 #endif
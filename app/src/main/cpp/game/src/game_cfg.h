@@ -1,3 +1,5 @@
+#pragma once
+
 #include <array>
 #include <vector>
 
@@ -8,17 +10,27 @@
 #define WINDOW_WIDTH   432
 #define WINDOW_HEIGHT  864
 #define MAX_WIDTH 512.f
+#define TARGET_FPS     60
+#define IDLE_FPS       20
+#define IDLE_AFTER_FRAMES 30
+#define MAX_RENDER_SCALE 2
+#define MIN_SCALED_TILE_PIXEL 3.0f
+#define QUALITY_SMOOTHING 0.1f
+#define QUALITY_OVERLOAD 1.15f
+#define QUALITY_HEADROOM 1.05f
+#define QUALITY_STEP_COOLDOWN 0.5f
+#define QUALITY_RESTORE_TIME 2.0f
 #define BOARD_WIDTH    9
 #define BOARD_HEIGHT   36
 #define TILE_SIZE      16.0f
-#ifdef PLATFORM_ANDROID
-    #define TILE_RADIUS    std::min(GetScreenWidth(), GetScreenHeight()) / (BOARD_WIDTH * 2.0f)
-#else
-    #define TILE_RADIUS    std::min(std::min(GetScreenWidth(), GetScreenHeight()) / (BOARD_WIDTH * 2.0f), MAX_WIDTH / (BOARD_WIDTH * 2.0f))
-#endif
-#define TILE_PIXEL     (TILE_RADIUS * 2.0f) / TILE_SIZE
+#define TILE_RADIUS    gs.tmp.layout.tileRadius
+#define TILE_PIXEL     gs.tmp.layout.tilePixel
 #define MAX_PARTICLES  1024
-#define MAX_TODROP     1024
+#define MAX_FALLING_PARTICLES 4096
+#define MAX_SHOCKWAVES 128
+#define MAX_CACHED_TEXTS 32
+#define MAX_TODROP     (BOARD_WIDTH * BOARD_HEIGHT)
+#define MAX_SIM_EVENTS 4096
 
 #define BOARD_EMP_BOT_ROW_GAP 10
 #define BOARD_WARNING_GAP 3
@@ -28,14 +40,18 @@
 #define RAND_FLOAT static_cast <float> (rand()) / (static_cast <float> (RAND_MAX) + 1.0f)
 #define RAND_FLOAT_SIGNED (2.0f * RAND_FLOAT - 1.0f)
 #define RAND_FLOAT_SIGNED_2D Vector2{RAND_FLOAT_SIGNED, RAND_FLOAT_SIGNED}
-#define UPDATE_ITS  5
-#define ROW_HEIGHT (float)(TILE_RADIUS * sqrt(3))
+#define MAX_BULLET_LEGS 16
+#define MAX_AIM_DOTS   50
+#define AIM_DOT_SIDES  12
+#define AIM_DOT_STEP   TILE_RADIUS * 2
+#define ROW_HEIGHT gs.tmp.layout.rowHeight
 #define BOARD_MOVE_TIME_PER_LINE 5.0f
 #define GAME_START_TIME 1.0f
 #define GAME_OVER_TIME_PER_ROW 0.1f
 #define GAME_OVER_TIMEOUT 3.0f
 #define GAME_OVER_TIMEOUT_BEF 1.0f
-#define BULLET_SPEED 75.0f * TILE_RADIUS
+#define BULLET_SPEED gs.tmp.layout.bulletSpeed
+#define BULLET_SPEED_IN_RADII 75.0f
 #define BULLET_RADIUS_V TILE_RADIUS
 #define BULLET_RADIUS_H TILE_RADIUS * 0.5f
 #define BULLET_REBOUNCE TILE_RADIUS
@@ -51,8 +67,6 @@
 #define GRAVITY 2500.0f
 #define COLORS std::array<Color, 5>{ RED, GREEN, BLUE, GOLD, PINK }
 #define COMBO_COLORS std::array<Color, 5>{ WHITE, GREEN, YELLOW, ORANGE, RED }
-#define TOGOI std::vector<int>{1, 0, 3, 2, 5, 4}
-#define TOGO std::vector<ThingPos>{{pos.row, pos.col + 1}, {pos.row, pos.col - 1}, {pos.row - 1, pos.col}, {pos.row + 1, pos.col}, {pos.row - 1, ((pos.row + gs.board.even) % 2) ? (pos.col + 1) : (pos.col - 1)}, {pos.row + 1, ((pos.row + gs.board.even) % 2) ? (pos.col + 1) : (pos.col - 1)}}
 #ifdef PLATFORM_ANDROID
     #define INPUT_TIMEOUT 1.0f
 #else
@@ -61,6 +75,13 @@
 #define REARM_TIMEOUT 0.25f
 #define N_TO_DROP 4
 #define WAVE_FADE_TIME 1.0f
+#define WAVE_SPEED 10.0f
+#define WAVE_FREQUENCY 30.0f
+#define WAVE_FRONT_FADE 0.2f
+#define WAVE_AMPLITUDE 0.5f
+#define WAVE_DIST_FADE 7.0f
+#define RIPPLE_GRID_COLS 36
+#define RIPPLE_GRID_ROWS 72
 #define BOMB_PROB 0.03f
 #define BOMB_TRIGGER_TIME 0.5f
 #define EXPLOSION_TIME 0.4f
@@ -0,0 +1,103 @@
+#include <stdlib.h>
+const char res_board_vs[] = {
+0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x33, 
+0x33, 0x30, 0x0d, 0x0a, 0x0d, 0x0a, 0x70, 0x72, 0x65, 0x63, 
+0x69, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x68, 0x69, 0x67, 0x68, 
+0x70, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x3b, 0x0d, 0x0a, 
+0x0d, 0x0a, 0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 
+0x76, 0x65, 0x72, 0x74, 0x65, 0x78, 0x50, 0x6f, 0x73, 0x69, 
+0x74, 0x69, 0x6f, 0x6e, 0x3b, 0x0d, 0x0a, 0x69, 0x6e, 0x20, 
+0x76, 0x65, 0x63, 0x32, 0x20, 0x76, 0x65, 0x72, 0x74, 0x65, 
+0x78, 0x54, 0x65, 0x78, 0x43, 0x6f, 0x6f, 0x72, 0x64, 0x3b, 
+0x0d, 0x0a, 0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 
+0x76, 0x65, 0x72, 0x74, 0x65, 0x78, 0x54, 0x65, 0x78, 0x43, 
+0x6f, 0x6f, 0x72, 0x64, 0x32, 0x3b, 0x0d, 0x0a, 0x69, 0x6e, 
+0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x76, 0x65, 0x72, 0x74, 
+0x65, 0x78, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x3b, 0x0d, 0x0a, 
+0x0d, 0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 
+0x6d, 0x61, 0x74, 0x34, 0x20, 0x6d, 0x76, 0x70, 0x3b, 0x0d, 
+0x0a, 0x0d, 0x0a, 0x2f, 0x2f, 0x20, 0x42, 0x6f, 0x61, 0x72, 
+0x64, 0x20, 0x74, 0x6f, 0x70, 0x2d, 0x6c, 0x65, 0x66, 0x74, 
+0x20, 0x69, 0x6e, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6c, 0x73, 
+0x3b, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6d, 0x65, 0x73, 0x68, 
+0x20, 0x69, 0x74, 0x73, 0x65, 0x6c, 0x66, 0x20, 0x69, 0x73, 
+0x20, 0x62, 0x75, 0x69, 0x6c, 0x74, 0x20, 0x61, 0x72, 0x6f, 
+0x75, 0x6e, 0x64, 0x20, 0x28, 0x30, 0x2c, 0x20, 0x30, 0x29, 
+0x0d, 0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 
+0x76, 0x65, 0x63, 0x32, 0x20, 0x62, 0x6f, 0x61, 0x72, 0x64, 
+0x4f, 0x66, 0x66, 0x73, 0x65, 0x74, 0x3b, 0x0d, 0x0a, 0x2f, 
+0x2f, 0x20, 0x4e, 0x65, 0x77, 0x20, 0x65, 0x76, 0x65, 0x72, 
+0x79, 0x20, 0x66, 0x72, 0x61, 0x6d, 0x65, 0x2c, 0x20, 0x73, 
+0x6f, 0x20, 0x65, 0x61, 0x63, 0x68, 0x20, 0x74, 0x69, 0x6c, 
+0x65, 0x20, 0x6a, 0x69, 0x74, 0x74, 0x65, 0x72, 0x73, 0x20, 
+0x74, 0x6f, 0x20, 0x61, 0x20, 0x66, 0x72, 0x65, 0x73, 0x68, 
+0x20, 0x73, 0x70, 0x6f, 0x74, 0x0d, 0x0a, 0x75, 0x6e, 0x69, 
+0x66, 0x6f, 0x72, 0x6d, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 
+0x20, 0x73, 0x68, 0x61, 0x6b, 0x65, 0x53, 0x65, 0x65, 0x64, 
+0x3b, 0x0d, 0x0a, 0x2f, 0x2f, 0x20, 0x50, 0x69, 0x78, 0x65, 
+0x6c, 0x73, 0x20, 0x61, 0x20, 0x74, 0x69, 0x6c, 0x65, 0x20, 
+0x6d, 0x6f, 0x76, 0x65, 0x73, 0x20, 0x61, 0x74, 0x20, 0x66, 
+0x75, 0x6c, 0x6c, 0x20, 0x73, 0x68, 0x61, 0x6b, 0x65, 0x0d, 
+0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x66, 
+0x6c, 0x6f, 0x61, 0x74, 0x20, 0x73, 0x68, 0x61, 0x6b, 0x65, 
+0x53, 0x74, 0x72, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x6f, 0x75, 
+0x74, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x66, 0x72, 0x61, 
+0x67, 0x54, 0x65, 0x78, 0x43, 0x6f, 0x6f, 0x72, 0x64, 0x3b, 
+0x0d, 0x0a, 0x6f, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 
+0x20, 0x66, 0x72, 0x61, 0x67, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 
+0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x66, 0x6c, 0x6f, 0x61, 0x74, 
+0x20, 0x72, 0x61, 0x6e, 0x64, 0x28, 0x66, 0x6c, 0x6f, 0x61, 
+0x74, 0x20, 0x6e, 0x29, 0x0d, 0x0a, 0x7b, 0x0d, 0x0a, 0x20, 
+0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x20, 
+0x66, 0x72, 0x61, 0x63, 0x74, 0x28, 0x73, 0x69, 0x6e, 0x28, 
+0x6e, 0x20, 0x2a, 0x20, 0x31, 0x32, 0x2e, 0x39, 0x38, 0x39, 
+0x38, 0x20, 0x2b, 0x20, 0x73, 0x68, 0x61, 0x6b, 0x65, 0x53, 
+0x65, 0x65, 0x64, 0x20, 0x2a, 0x20, 0x37, 0x38, 0x2e, 0x32, 
+0x33, 0x33, 0x29, 0x20, 0x2a, 0x20, 0x34, 0x33, 0x37, 0x35, 
+0x38, 0x2e, 0x35, 0x34, 0x35, 0x33, 0x29, 0x20, 0x2a, 0x20, 
+0x32, 0x2e, 0x20, 0x2d, 0x20, 0x31, 0x2e, 0x3b, 0x0d, 0x0a, 
+0x7d, 0x0d, 0x0a, 0x0d, 0x0a, 0x76, 0x6f, 0x69, 0x64, 0x20, 
+0x6d, 0x61, 0x69, 0x6e, 0x28, 0x29, 0x0d, 0x0a, 0x7b, 0x0d, 
+0x0a, 0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0x76, 0x65, 
+0x72, 0x74, 0x65, 0x78, 0x54, 0x65, 0x78, 0x43, 0x6f, 0x6f, 
+0x72, 0x64, 0x32, 0x3a, 0x20, 0x78, 0x20, 0x3d, 0x20, 0x74, 
+0x69, 0x6c, 0x65, 0x20, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x2c, 
+0x20, 0x74, 0x68, 0x65, 0x20, 0x73, 0x61, 0x6d, 0x65, 0x20, 
+0x66, 0x6f, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x74, 0x69, 
+0x6c, 0x65, 0x27, 0x73, 0x20, 0x34, 0x20, 0x63, 0x6f, 0x72, 
+0x6e, 0x65, 0x72, 0x73, 0x2c, 0x20, 0x79, 0x20, 0x3d, 0x20, 
+0x73, 0x68, 0x61, 0x6b, 0x65, 0x20, 0x61, 0x6d, 0x6f, 0x75, 
+0x6e, 0x74, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6c, 
+0x6f, 0x61, 0x74, 0x20, 0x74, 0x69, 0x6c, 0x65, 0x20, 0x3d, 
+0x20, 0x76, 0x65, 0x72, 0x74, 0x65, 0x78, 0x54, 0x65, 0x78, 
+0x43, 0x6f, 0x6f, 0x72, 0x64, 0x32, 0x2e, 0x78, 0x3b, 0x0d, 
+0x0a, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 
+0x73, 0x68, 0x61, 0x6b, 0x65, 0x20, 0x3d, 0x20, 0x73, 0x68, 
+0x61, 0x6b, 0x65, 0x53, 0x74, 0x72, 0x20, 0x2a, 0x20, 0x76, 
+0x65, 0x72, 0x74, 0x65, 0x78, 0x54, 0x65, 0x78, 0x43, 0x6f, 
+0x6f, 0x72, 0x64, 0x32, 0x2e, 0x79, 0x20, 0x2a, 0x20, 0x76, 
+0x65, 0x63, 0x32, 0x28, 0x72, 0x61, 0x6e, 0x64, 0x28, 0x74, 
+0x69, 0x6c, 0x65, 0x29, 0x2c, 0x20, 0x72, 0x61, 0x6e, 0x64, 
+0x28, 0x74, 0x69, 0x6c, 0x65, 0x20, 0x2b, 0x20, 0x30, 0x2e, 
+0x35, 0x29, 0x29, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 
+0x76, 0x65, 0x63, 0x32, 0x20, 0x70, 0x6f, 0x73, 0x20, 0x3d, 
+0x20, 0x76, 0x65, 0x72, 0x74, 0x65, 0x78, 0x50, 0x6f, 0x73, 
+0x69, 0x74, 0x69, 0x6f, 0x6e, 0x2e, 0x78, 0x79, 0x20, 0x2b, 
+0x20, 0x66, 0x6c, 0x6f, 0x6f, 0x72, 0x28, 0x62, 0x6f, 0x61, 
+0x72, 0x64, 0x4f, 0x66, 0x66, 0x73, 0x65, 0x74, 0x20, 0x2b, 
+0x20, 0x73, 0x68, 0x61, 0x6b, 0x65, 0x29, 0x3b, 0x0d, 0x0a, 
+0x20, 0x20, 0x20, 0x20, 0x66, 0x72, 0x61, 0x67, 0x54, 0x65, 
+0x78, 0x43, 0x6f, 0x6f, 0x72, 0x64, 0x20, 0x3d, 0x20, 0x76, 
+0x65, 0x72, 0x74, 0x65, 0x78, 0x54, 0x65, 0x78, 0x43, 0x6f, 
+0x6f, 0x72, 0x64, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 
+0x66, 0x72, 0x61, 0x67, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x20, 
+0x3d, 0x20, 0x76, 0x65, 0x72, 0x74, 0x65, 0x78, 0x43, 0x6f, 
+0x6c, 0x6f, 0x72, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 
+0x67, 0x6c, 0x5f, 0x50, 0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f, 
+0x6e, 0x20, 0x3d, 0x20, 0x6d, 0x76, 0x70, 0x20, 0x2a, 0x20, 
+0x76, 0x65, 0x63, 0x34, 0x28, 0x70, 0x6f, 0x73, 0x2c, 0x20, 
+0x30, 0x2e, 0x2c, 0x20, 0x31, 0x2e, 0x29, 0x3b, 0x0d, 0x0a, 
+0x7d, 0x0d, 0x0a, 
+0x00};
+const size_t res_board_vs_len = sizeof(res_board_vs);
+
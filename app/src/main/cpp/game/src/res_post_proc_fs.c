@@ -11,181 +11,31 @@ const char res_post_proc_fs[] = {
 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x30, 0x3b, 0x0d, 0x0a, 
 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x76, 0x65, 
 0x63, 0x34, 0x20, 0x63, 0x6f, 0x6c, 0x44, 0x69, 0x66, 0x66, 
-0x75, 0x73, 0x65, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x75, 0x6e, 
-0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x69, 0x6e, 0x74, 0x20, 
-0x6e, 0x44, 0x72, 0x6f, 0x70, 0x73, 0x3b, 0x0d, 0x0a, 0x75, 
-0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x76, 0x65, 0x63, 
-0x32, 0x20, 0x64, 0x72, 0x6f, 0x70, 0x43, 0x65, 0x6e, 0x74, 
-0x65, 0x72, 0x73, 0x5b, 0x31, 0x32, 0x38, 0x5d, 0x3b, 0x0d, 
-0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x66, 
-0x6c, 0x6f, 0x61, 0x74, 0x20, 0x64, 0x72, 0x6f, 0x70, 0x54, 
-0x69, 0x6d, 0x65, 0x73, 0x5b, 0x31, 0x32, 0x38, 0x5d, 0x3b, 
-0x0d, 0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 
-0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 0x74, 0x69, 0x6d, 0x65, 
-0x3b, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x0d, 0x0a, 
-0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x76, 0x65, 
-0x63, 0x32, 0x20, 0x73, 0x63, 0x72, 0x65, 0x65, 0x6e, 0x53, 
-0x69, 0x7a, 0x65, 0x3b, 0x0d, 0x0a, 0x75, 0x6e, 0x69, 0x66, 
-0x6f, 0x72, 0x6d, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 
-0x62, 0x57, 0x69, 0x64, 0x74, 0x68, 0x3b, 0x0d, 0x0a, 0x0d, 
-0x0a, 0x6f, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 
+0x75, 0x73, 0x65, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x6f, 0x75, 
+0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x66, 0x69, 0x6e, 
+0x61, 0x6c, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x3b, 0x0d, 0x0a, 
+0x0d, 0x0a, 0x2f, 0x2f, 0x20, 0x54, 0x68, 0x65, 0x20, 0x73, 
+0x68, 0x6f, 0x63, 0x6b, 0x77, 0x61, 0x76, 0x65, 0x20, 0x72, 
+0x69, 0x70, 0x70, 0x6c, 0x65, 0x73, 0x20, 0x61, 0x72, 0x65, 
+0x20, 0x61, 0x6c, 0x72, 0x65, 0x61, 0x64, 0x79, 0x20, 0x69, 
+0x6e, 0x20, 0x66, 0x72, 0x61, 0x67, 0x54, 0x65, 0x78, 0x43, 
+0x6f, 0x6f, 0x72, 0x64, 0x3a, 0x20, 0x74, 0x68, 0x65, 0x20, 
+0x72, 0x69, 0x70, 0x70, 0x6c, 0x65, 0x20, 0x67, 0x72, 0x69, 
+0x64, 0x27, 0x73, 0x20, 0x76, 0x65, 0x72, 0x74, 0x69, 0x63, 
+0x65, 0x73, 0x20, 0x63, 0x61, 0x72, 0x72, 0x79, 0x0d, 0x0a, 
+0x2f, 0x2f, 0x20, 0x74, 0x68, 0x65, 0x6d, 0x2c, 0x20, 0x73, 
+0x65, 0x65, 0x20, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65, 0x52, 
+0x69, 0x70, 0x70, 0x6c, 0x65, 0x47, 0x72, 0x69, 0x64, 0x0d, 
+0x0a, 0x76, 0x6f, 0x69, 0x64, 0x20, 0x6d, 0x61, 0x69, 0x6e, 
+0x28, 0x29, 0x20, 0x7b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 
 0x66, 0x69, 0x6e, 0x61, 0x6c, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 
-0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x76, 0x6f, 0x69, 0x64, 0x20, 
-0x6d, 0x61, 0x69, 0x6e, 0x28, 0x29, 0x20, 0x7b, 0x0d, 0x0a, 
-0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x28, 0x6e, 0x44, 
-0x72, 0x6f, 0x70, 0x73, 0x20, 0x3e, 0x20, 0x30, 0x29, 0x20, 
-0x7b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x75, 0x76, 0x20, 0x3d, 
-0x20, 0x66, 0x72, 0x61, 0x67, 0x54, 0x65, 0x78, 0x43, 0x6f, 
-0x6f, 0x72, 0x64, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6f, 0x72, 0x20, 
-0x28, 0x69, 0x6e, 0x74, 0x20, 0x69, 0x20, 0x3d, 0x20, 0x30, 
-0x3b, 0x20, 0x69, 0x20, 0x3c, 0x20, 0x6e, 0x44, 0x72, 0x6f, 
-0x70, 0x73, 0x3b, 0x20, 0x2b, 0x2b, 0x69, 0x29, 0x20, 0x7b, 
-0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0x43, 0x6f, 0x6e, 
-0x76, 0x65, 0x72, 0x74, 0x20, 0x64, 0x72, 0x6f, 0x70, 0x20, 
-0x63, 0x65, 0x6e, 0x74, 0x65, 0x72, 0x20, 0x66, 0x72, 0x6f, 
-0x6d, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6c, 0x73, 0x20, 0x74, 
-0x6f, 0x20, 0x55, 0x56, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 
-0x63, 0x32, 0x20, 0x64, 0x72, 0x6f, 0x70, 0x55, 0x56, 0x20, 
-0x3d, 0x20, 0x76, 0x65, 0x63, 0x32, 0x28, 0x64, 0x72, 0x6f, 
-0x70, 0x43, 0x65, 0x6e, 0x74, 0x65, 0x72, 0x73, 0x5b, 0x69, 
-0x5d, 0x2e, 0x78, 0x2c, 0x20, 0x73, 0x63, 0x72, 0x65, 0x65, 
-0x6e, 0x53, 0x69, 0x7a, 0x65, 0x2e, 0x79, 0x20, 0x2d, 0x20, 
-0x64, 0x72, 0x6f, 0x70, 0x43, 0x65, 0x6e, 0x74, 0x65, 0x72, 
-0x73, 0x5b, 0x69, 0x5d, 0x2e, 0x79, 0x29, 0x20, 0x2f, 0x20, 
-0x73, 0x63, 0x72, 0x65, 0x65, 0x6e, 0x53, 0x69, 0x7a, 0x65, 
-0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 
-0x54, 0x69, 0x6d, 0x65, 0x20, 0x73, 0x69, 0x6e, 0x63, 0x65, 
-0x20, 0x64, 0x72, 0x6f, 0x70, 0x20, 0x73, 0x74, 0x61, 0x72, 
-0x74, 0x65, 0x64, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6c, 0x6f, 
-0x61, 0x74, 0x20, 0x74, 0x20, 0x3d, 0x20, 0x74, 0x69, 0x6d, 
-0x65, 0x20, 0x2d, 0x20, 0x64, 0x72, 0x6f, 0x70, 0x54, 0x69, 
-0x6d, 0x65, 0x73, 0x5b, 0x69, 0x5d, 0x3b, 0x0d, 0x0a, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x69, 0x66, 0x20, 0x28, 0x74, 0x20, 0x3c, 0x20, 0x30, 
-0x2e, 0x30, 0x29, 0x20, 0x7b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0x44, 0x72, 0x6f, 0x70, 
-0x20, 0x68, 0x61, 0x73, 0x6e, 0x27, 0x74, 0x20, 0x68, 0x61, 
-0x70, 0x70, 0x65, 0x6e, 0x65, 0x64, 0x20, 0x79, 0x65, 0x74, 
-0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x69, 
-0x6e, 0x61, 0x6c, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x3d, 
-0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x28, 0x74, 
-0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x30, 0x2c, 0x20, 0x75, 
-0x76, 0x29, 0x20, 0x2a, 0x20, 0x66, 0x72, 0x61, 0x67, 0x43, 
-0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x2a, 0x20, 0x63, 0x6f, 0x6c, 
-0x44, 0x69, 0x66, 0x66, 0x75, 0x73, 0x65, 0x3b, 0x0d, 0x0a, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 
-0x72, 0x6e, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x7d, 0x0d, 0x0a, 
-0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0x56, 0x65, 0x63, 
-0x74, 0x6f, 0x72, 0x20, 0x66, 0x72, 0x6f, 0x6d, 0x20, 0x63, 
-0x65, 0x6e, 0x74, 0x65, 0x72, 0x20, 0x74, 0x6f, 0x20, 0x70, 
-0x69, 0x78, 0x65, 0x6c, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 
-0x63, 0x32, 0x20, 0x64, 0x65, 0x6c, 0x74, 0x61, 0x20, 0x3d, 
-0x20, 0x28, 0x75, 0x76, 0x20, 0x2d, 0x20, 0x64, 0x72, 0x6f, 
-0x70, 0x55, 0x56, 0x29, 0x20, 0x2a, 0x20, 0x76, 0x65, 0x63, 
-0x32, 0x28, 0x31, 0x2e, 0x2c, 0x20, 0x73, 0x63, 0x72, 0x65, 
-0x65, 0x6e, 0x53, 0x69, 0x7a, 0x65, 0x2e, 0x79, 0x20, 0x2f, 
-0x20, 0x73, 0x63, 0x72, 0x65, 0x65, 0x6e, 0x53, 0x69, 0x7a, 
-0x65, 0x2e, 0x78, 0x29, 0x20, 0x2a, 0x20, 0x28, 0x73, 0x63, 
-0x72, 0x65, 0x65, 0x6e, 0x53, 0x69, 0x7a, 0x65, 0x2e, 0x78, 
-0x20, 0x2f, 0x20, 0x62, 0x57, 0x69, 0x64, 0x74, 0x68, 0x29, 
-0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 
-0x20, 0x64, 0x69, 0x73, 0x74, 0x20, 0x3d, 0x20, 0x6c, 0x65, 
-0x6e, 0x67, 0x74, 0x68, 0x28, 0x64, 0x65, 0x6c, 0x74, 0x61, 
-0x29, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 
-0x20, 0x57, 0x61, 0x76, 0x65, 0x20, 0x70, 0x61, 0x72, 0x61, 
-0x6d, 0x65, 0x74, 0x65, 0x72, 0x73, 0x0d, 0x0a, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 0x73, 0x70, 0x65, 0x65, 
-0x64, 0x20, 0x3d, 0x20, 0x31, 0x30, 0x2e, 0x3b, 0x0d, 0x0a, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 0x66, 0x72, 
-0x65, 0x71, 0x75, 0x65, 0x6e, 0x63, 0x79, 0x20, 0x3d, 0x20, 
-0x33, 0x30, 0x2e, 0x30, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 
-0x6c, 0x6f, 0x61, 0x74, 0x20, 0x74, 0x69, 0x6d, 0x65, 0x46, 
-0x61, 0x64, 0x65, 0x20, 0x3d, 0x20, 0x30, 0x2e, 0x32, 0x3b, 
-0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 
-0x61, 0x6d, 0x70, 0x6c, 0x69, 0x74, 0x75, 0x64, 0x65, 0x20, 
-0x3d, 0x20, 0x30, 0x2e, 0x35, 0x20, 0x2a, 0x20, 0x28, 0x31, 
-0x2e, 0x30, 0x20, 0x2d, 0x20, 0x63, 0x6c, 0x61, 0x6d, 0x70, 
-0x28, 0x28, 0x74, 0x20, 0x2d, 0x20, 0x64, 0x69, 0x73, 0x74, 
-0x29, 0x2f, 0x74, 0x69, 0x6d, 0x65, 0x46, 0x61, 0x64, 0x65, 
-0x2c, 0x20, 0x30, 0x2e, 0x2c, 0x20, 0x31, 0x2e, 0x29, 0x29, 
-0x20, 0x2a, 0x20, 0x28, 0x62, 0x57, 0x69, 0x64, 0x74, 0x68, 
-0x20, 0x2f, 0x20, 0x73, 0x63, 0x72, 0x65, 0x65, 0x6e, 0x53, 
-0x69, 0x7a, 0x65, 0x2e, 0x78, 0x29, 0x3b, 0x0d, 0x0a, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 0x66, 0x61, 0x64, 
-0x65, 0x20, 0x3d, 0x20, 0x37, 0x2e, 0x30, 0x3b, 0x0d, 0x0a, 
-0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 
-0x77, 0x61, 0x76, 0x65, 0x20, 0x3d, 0x20, 0x73, 0x69, 0x6e, 
-0x28, 0x64, 0x69, 0x73, 0x74, 0x20, 0x2a, 0x20, 0x66, 0x72, 
-0x65, 0x71, 0x75, 0x65, 0x6e, 0x63, 0x79, 0x20, 0x2d, 0x20, 
-0x74, 0x20, 0x2a, 0x20, 0x73, 0x70, 0x65, 0x65, 0x64, 0x29, 
-0x20, 0x2a, 0x20, 0x61, 0x6d, 0x70, 0x6c, 0x69, 0x74, 0x75, 
-0x64, 0x65, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x2f, 
-0x2f, 0x20, 0x41, 0x70, 0x70, 0x6c, 0x79, 0x20, 0x64, 0x69, 
-0x73, 0x74, 0x6f, 0x72, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x77, 
-0x68, 0x65, 0x72, 0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x77, 
-0x61, 0x76, 0x65, 0x20, 0x68, 0x61, 0x73, 0x20, 0x72, 0x65, 
-0x61, 0x63, 0x68, 0x65, 0x64, 0x0d, 0x0a, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 
-0x6c, 0x6f, 0x61, 0x74, 0x20, 0x6d, 0x61, 0x73, 0x6b, 0x20, 
-0x3d, 0x20, 0x73, 0x6d, 0x6f, 0x6f, 0x74, 0x68, 0x73, 0x74, 
-0x65, 0x70, 0x28, 0x30, 0x2e, 0x30, 0x2c, 0x20, 0x31, 0x2e, 
-0x30, 0x2c, 0x20, 0x74, 0x20, 0x2a, 0x20, 0x73, 0x70, 0x65, 
-0x65, 0x64, 0x20, 0x2d, 0x20, 0x64, 0x69, 0x73, 0x74, 0x29, 
-0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x75, 0x76, 0x20, 0x2b, 0x3d, 
-0x20, 0x6e, 0x6f, 0x72, 0x6d, 0x61, 0x6c, 0x69, 0x7a, 0x65, 
-0x28, 0x64, 0x65, 0x6c, 0x74, 0x61, 0x29, 0x20, 0x2a, 0x20, 
-0x77, 0x61, 0x76, 0x65, 0x20, 0x2a, 0x20, 0x6d, 0x61, 0x73, 
-0x6b, 0x20, 0x2a, 0x20, 0x65, 0x78, 0x70, 0x28, 0x2d, 0x64, 
-0x69, 0x73, 0x74, 0x20, 0x2a, 0x20, 0x66, 0x61, 0x64, 0x65, 
-0x29, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x7d, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 
-0x74, 0x65, 0x78, 0x65, 0x6c, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 
 0x20, 0x3d, 0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 
 0x28, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x30, 0x2c, 
-0x20, 0x75, 0x76, 0x29, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x69, 0x6e, 0x61, 0x6c, 
-0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x3d, 0x20, 0x74, 0x65, 
-0x78, 0x65, 0x6c, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x2a, 
-0x20, 0x66, 0x72, 0x61, 0x67, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 
-0x20, 0x2a, 0x20, 0x63, 0x6f, 0x6c, 0x44, 0x69, 0x66, 0x66, 
-0x75, 0x73, 0x65, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 
-0x7d, 0x20, 0x65, 0x6c, 0x73, 0x65, 0x20, 0x7b, 0x0d, 0x0a, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 
-0x63, 0x34, 0x20, 0x74, 0x65, 0x78, 0x65, 0x6c, 0x43, 0x6f, 
-0x6c, 0x6f, 0x72, 0x20, 0x3d, 0x20, 0x74, 0x65, 0x78, 0x74, 
-0x75, 0x72, 0x65, 0x28, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 
-0x65, 0x30, 0x2c, 0x20, 0x66, 0x72, 0x61, 0x67, 0x54, 0x65, 
-0x78, 0x43, 0x6f, 0x6f, 0x72, 0x64, 0x29, 0x3b, 0x0d, 0x0a, 
-0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x69, 
-0x6e, 0x61, 0x6c, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x3d, 
-0x20, 0x74, 0x65, 0x78, 0x65, 0x6c, 0x43, 0x6f, 0x6c, 0x6f, 
-0x72, 0x20, 0x2a, 0x20, 0x66, 0x72, 0x61, 0x67, 0x43, 0x6f, 
-0x6c, 0x6f, 0x72, 0x20, 0x2a, 0x20, 0x63, 0x6f, 0x6c, 0x44, 
-0x69, 0x66, 0x66, 0x75, 0x73, 0x65, 0x3b, 0x0d, 0x0a, 0x20, 
-0x20, 0x20, 0x20, 0x7d, 0x0d, 0x0a, 0x7d, 0x0d, 0x0a, 
+0x20, 0x66, 0x72, 0x61, 0x67, 0x54, 0x65, 0x78, 0x43, 0x6f, 
+0x6f, 0x72, 0x64, 0x29, 0x20, 0x2a, 0x20, 0x66, 0x72, 0x61, 
+0x67, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x2a, 0x20, 0x63, 
+0x6f, 0x6c, 0x44, 0x69, 0x66, 0x66, 0x75, 0x73, 0x65, 0x3b, 
+0x0d, 0x0a, 0x7d, 0x0d, 0x0a, 
 0x00};
 const size_t res_post_proc_fs_len = sizeof(res_post_proc_fs);
 
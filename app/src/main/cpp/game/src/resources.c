@@ -3,6 +3,9 @@
 extern const unsigned char res_beep_ogg[];
 extern const unsigned long long res_beep_ogg_len;
 
+extern const unsigned char res_board_vs[];
+extern const unsigned long long res_board_vs_len;
+
 extern const unsigned char res_clang0_ogg[];
 extern const unsigned long long res_clang0_ogg_len;
 
@@ -0,0 +1,864 @@
+#include "sim.h"
+
+#include "util/profiler.h"
+#include "util/vec_ops.h"
+#include "raymath.h"
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+double getTime(const GameState& gs) {
+    return gs.tmp.frame.time;
+}
+
+float getFrameTime(const GameState& gs) {
+    return gs.tmp.frame.delta;
+}
+
+// Same value raylib's SetRandomSeed(seed) + GetRandomValue(min, max) gives (SplitMix64-seeded Xoshiro128**),
+// so boards stay identical with and without the platform layer
+int getRandVal(GameState& gs, int min, int max) {
+    uint64_t seed = gs.seed++;
+    auto splitmix = [&seed]() {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    };
+    splitmix();
+    uint32_t s1 = (uint32_t)((splitmix() & 0xffffffff00000000) >> 32);
+    uint32_t x = s1 * 5;
+    uint32_t val = ((x << 7) | (x >> 25)) * 9;
+    if (min > max) std::swap(min, max);
+    return int(val % uint32_t(max - min + 1)) + min;
+}
+
+float easeOutBounce(float x)
+{
+    float n1 = 7.5625f;
+    float d1 = 2.75f;
+
+    if (x < 1 / d1) {
+        return n1 * x * x;
+    } else if (x < 2 / d1) {
+        return n1 * (x - 1.5 / d1) * (x - 1.5 / d1) + 0.75;
+    } else if (x < 2.5 / d1) {
+        return n1 * (x - 2.25 / d1) * (x - 2.25 / d1) + 0.9375;
+    } else {
+        return n1 * (x - 2.625 / d1) * (x - 2.625 / d1) + 0.984375;
+    }
+}
+
+float easeOutQuad(float t) {
+    return 1 - (1 - t) * (1 - t);
+}
+
+float easeInQuad(float t) {
+    return t * t;
+}
+
+void updateBoardRect(GameState& gs) {
+    float bWidth = TILE_RADIUS * 2 * BOARD_WIDTH;
+    float bHeight = ROW_HEIGHT * BOARD_HEIGHT;
+    float startCoeff = easeOutQuad(std::clamp((getTime(gs) - gs.gameStartTime)/GAME_START_TIME, 0.0, 1.0));
+    Vector2 bPos = {(gs.tmp.frame.width - bWidth) * 0.5f, gs.tmp.frame.height - 2 * bHeight + bHeight * startCoeff + gs.board.pos};
+    gs.tmp.layout.board = {float(int(bPos.x)), float(int(bPos.y)), bWidth, bHeight};
+}
+
+void setFrame(GameState& gs, const SimFrame& frame) {
+    gs.tmp.frame = frame;
+    auto& lay = gs.tmp.layout;
+    lay.tileRadius = std::min(frame.width, frame.height) / (BOARD_WIDTH * 2.0f);
+#ifndef PLATFORM_ANDROID
+    lay.tileRadius = std::min(lay.tileRadius, MAX_WIDTH / (BOARD_WIDTH * 2.0f));
+#endif
+    lay.rowHeight = (float)(lay.tileRadius * sqrt(3));
+    lay.tilePixel = (lay.tileRadius * 2.0f) / TILE_SIZE;
+    lay.bulletSpeed = BULLET_SPEED_IN_RADII * lay.tileRadius;
+    updateBoardRect(gs);
+}
+
+Rectangle getBoardRect(const GameState& gs) {
+    return gs.tmp.layout.board;
+}
+
+ThingPos getPosByPix(const GameState& gs, const Rectangle& brec, const Vector2& pix) {
+    int row = std::clamp((int)floor((pix.y - brec.y) / ROW_HEIGHT), 0, BOARD_HEIGHT - 1);
+    bool shortRow = ((row + gs.board.even) % 2);
+    int col = std::clamp((int)floor((pix.x - brec.x - float(shortRow) * TILE_RADIUS) / (TILE_RADIUS * 2)), 0, shortRow ? (BOARD_WIDTH - 2) : (BOARD_WIDTH - 1));
+    return {row, col};
+}
+
+ThingPos getPosByPix(const GameState& gs, const Vector2& pix) {
+    return getPosByPix(gs, getBoardRect(gs), pix);
+}
+
+Vector2 getPixByPos(const GameState& gs, const Rectangle& brec, const ThingPos& pos) {
+    float offset = float((pos.row + gs.board.even) % 2) * TILE_RADIUS;
+    return {float(int(offset + brec.x + TILE_RADIUS + pos.col * TILE_RADIUS * 2)), (float)int(brec.y + (pos.row + 0.5f) * ROW_HEIGHT)};
+}
+
+Vector2 getPixByPos(const GameState& gs, const ThingPos& pos) {
+    return getPixByPos(gs, getBoardRect(gs), pos);
+}
+
+bool checkBounds(const GameState& gs, const ThingPos& pos) {
+    return inBoard(gs.board.even, pos.row, pos.col);
+}
+
+Tile& getTile(GameState& gs, const ThingPos& pos) {
+    return gs.board.things[pos.row][pos.col];
+}
+
+void emit(GameState& gs, const SimEvent& ev) {
+    gs.tmp.events.acquire(ev);
+}
+
+void emitSound(GameState& gs, SimSound snd) {
+    emit(gs, {SimEventType::SOUND, (uint8_t)snd});
+}
+
+void emitAnimation(GameState& gs, SimAnim anim, Vector2 pos, Color col = WHITE) {
+    emit(gs, {SimEventType::ANIMATION, (uint8_t)anim, {}, pos, Vector2Zero(), col});
+}
+
+void emitParticle(GameState& gs, const Thing& thing, Vector2 pos, Vector2 vel) {
+    emit(gs, {SimEventType::PARTICLE, 0, thing, pos, vel});
+}
+
+void emitShatter(GameState& gs, const Thing& thing, Vector2 pos) {
+    emit(gs, {SimEventType::SHATTER, (uint8_t)getRandVal(gs, 0, 2), thing, pos});
+}
+
+void addScorePoints(GameState& gs, Vector2 pos, Color col, int n) {
+    emit(gs, {SimEventType::SCORE, 0, {}, pos, Vector2Zero(), col, n});
+    gs.score += n;
+}
+
+int countBotEmpRows(const GameState& gs) {
+    int n = 0;
+    bool keep = true;
+    for (int row = BOARD_HEIGHT - 1; row >= 0; --row) {
+        for (int col = 0; col < BOARD_WIDTH - ((row + gs.board.even) % 2); ++col) {
+            if (gs.board.things[row][col].exists) {
+                keep = false;
+                break;
+            }
+        }
+        if (!keep) break;
+        n++;
+    }
+    return n;
+}
+
+bool checkFullRow(const GameState& gs, int row) {
+    bool fullrow = true;
+    for (int i = 0; i < BOARD_WIDTH - ((row + gs.board.even) % 2); ++i) {
+        if (!gs.board.things[row][i].exists) {
+            fullrow = false;
+            break;
+        }
+    }
+    return fullrow;
+}
+
+void addTile(GameState& gs, const ThingPos& pos, const Tile& tile, bool updateFullRows, bool makeExist) {
+    auto& th = gs.board.things[pos.row][pos.col];
+    th = tile;
+    if (makeExist) th.exists = true;
+    th.pos = pos;
+    gs.board.version++;
+
+    if (updateFullRows) {
+        int i = 0;
+        while ((pos.row - i > 0) && checkFullRow(gs, pos.row - i)) i++;
+        if (i > 0 && pos.row - i <= gs.board.nFulRowsTop)
+            gs.board.nFulRowsTop = pos.row + 1;
+    }
+}
+
+void generateRows(GameState& gs, int n) {
+    for (int row = 0; row < n; ++row) {
+        for (int col = 0; col < BOARD_WIDTH - ((row + gs.board.even) % 2); ++col) {
+            addTile(gs, {row, col}, Tile{(col != (BOARD_WIDTH - 1)) || ((row + gs.board.even) % 2 == 0), {row, col}, {(unsigned char)getRandVal(gs, 0, COLORS.size() - 1), (unsigned char)getRandVal(gs, 0, COLORS.size() - 1), (unsigned char)getRandVal(gs, 0, COLORS.size() - 1)}});
+            auto& thing = gs.board.things[row][col].thing;
+            thing.bomb = (getRandVal(gs, 0, 100000) < 100000 * BOMB_PROB);
+            thing.triggered = false;
+        }
+    }
+}
+
+void removeTile(GameState& gs, const ThingPos& pos) {
+    gs.board.things[pos.row][pos.col].exists = false;
+    gs.board.things[pos.row][pos.col].pos = pos;
+    gs.board.version++;
+    if (pos.row < gs.board.nFulRowsTop)
+        gs.board.nFulRowsTop = pos.row + 1;
+}
+
+void shiftBoard(GameState& gs, int off) {
+    if (off % 2 != 0)
+        gs.board.even = !gs.board.even;
+    if (off < 0) {
+        for (int row = 0; row < BOARD_HEIGHT - 1; ++row) {
+            for (int col = 0; col < BOARD_WIDTH - ((row + gs.board.even) % 2); ++col) {
+                if (row > BOARD_HEIGHT + off - 1)
+                    removeTile(gs, {row, col});
+                else
+                    addTile(gs, {row, col}, gs.board.things[row - off][col]);
+
+            }
+        }
+    } else {
+        for (int row = BOARD_HEIGHT - 1; row >= 0; --row) {
+            for (int col = 0; col < BOARD_WIDTH - ((row + gs.board.even) % 2); ++col) {
+                if (row < off)
+                    removeTile(gs, {row, col});
+                else
+                    addTile(gs, {row, col}, gs.board.things[row - off][col]);
+            }
+        }
+    }
+}
+
+void setNext(GameState& gs) {
+    gs.gun.next.shp = (unsigned char)getRandVal(gs, 0, COLORS.size() - 1);
+    gs.gun.next.clr = (unsigned char)getRandVal(gs, 0, COLORS.size() - 1);
+    gs.gun.next.sym = (unsigned char)getRandVal(gs, 0, COLORS.size() - 1);
+    gs.gun.nextArmed = true;
+}
+
+void rearm(GameState& gs) {
+    if (!gs.gun.nextArmed)
+        setNext(gs);
+    gs.gun.armed = gs.gun.next;
+    setNext(gs);
+    gs.rearmTime = getTime(gs);
+}
+
+void swapExtra(GameState& gs) {
+    if (gs.gun.extraArmed) {
+        auto e = gs.gun.extra;
+        gs.gun.extra = gs.gun.armed;
+        gs.gun.armed = e;
+        gs.gun.firstSwap = false;
+    } else {
+        gs.gun.extra = gs.gun.armed;
+        gs.gun.extraArmed = true;
+        rearm(gs);
+    }
+    emitSound(gs, SimSound::SWAP);
+    gs.swapTime = getTime(gs);
+}
+
+void resetGame(GameState& gs, unsigned int seed) {
+    auto version = gs.board.version;  // kept rising, so a new board never matches an old one's
+    resetInPlace(gs.board);
+    gs.board.version = version + 1;
+    resetInPlace(gs.gun);
+    resetInPlace(gs.bullet);
+    gs.score = 0;
+    gs.combo = 1;
+    gs.firstShotFired = false;
+    gs.gameOver = false;
+    gs.time = gs.gameStartTime = gs.gameOverTime = 0;
+    gs.inputTimeoutTime = gs.rearmTime = gs.swapTime = 0;
+    gs.musicLoopDone = false;
+    gs.settingsOpened = false;
+    gs.alteredDifficulty = false;
+    gs.seed = seed;
+    generateRows(gs, BOARD_HEIGHT - gs.board.nRowsGap);
+    rearm(gs);
+    gs.gameStartTime = getTime(gs);
+    updateBoardRect(gs);
+    emit(gs, {SimEventType::RESET});
+}
+
+Vector2 muzzlePos(const GameState& gs) {
+    auto brec = getBoardRect(gs);
+    return {(float)brec.x + brec.width * 0.5f, gs.tmp.frame.height - TILE_RADIUS};
+}
+
+Vector2 shotVel(const GameState& gs) {
+    float dir = gs.gun.dir + PI * 0.5f;
+    return BULLET_SPEED * Vector2{cos(dir), -sin(dir)};
+}
+
+void shootAndRearm(GameState& gs) {
+    gs.firstShotFired = true;
+    gs.bullet.exists = true;
+    gs.bullet.rebouncing = false;
+    gs.bullet.thing = gs.gun.armed;
+    gs.bullet.vel = shotVel(gs);
+    gs.bullet.pos = muzzlePos(gs);
+    emitSound(gs, SimSound::WHOOSH);
+    rearm(gs);
+}
+
+bool checkMatch(const Thing& th1, const Thing& th2, int param) {
+    if (th1.bomb || th2.bomb)
+        return false;
+    switch (param) {
+        case 0: return th1.clr == th2.clr;
+        case 1: return th1.shp == th2.shp;
+        case 2: return th1.sym == th2.sym;
+    }
+    return false;
+}
+
+BoardBits single(const ThingPos& pos) {
+    BoardBits res;
+    res.set(pos.row, pos.col);
+    return res;
+}
+
+// Tiles around `pos` matching `thing` by `param`, `pos` itself included only if it matches
+void collectMatching(GameState& gs, const ThingPos& pos, const Thing& thing, int param, PosArena& todrop) {
+    auto matches = [&](const ThingPos& p) {
+        const auto& tile = getTile(gs, p);
+        return tile.exists && checkMatch(tile.thing, thing, param);
+    };
+    if (matches(pos)) todrop.acquire(pos);
+    floodFill(gs, single(pos), [&](const ThingPos& n, int) {
+        if (!matches(n))
+            return false;
+        todrop.acquire(n);
+        return true;
+    });
+}
+
+BoardBits getExisting(const GameState& gs) {
+    BoardBits res;
+    for (int i = 0; i < BOARD_HEIGHT; ++i)
+        for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j)
+            if (gs.board.things[i][j].exists) res.set(i, j);
+    return res;
+}
+
+BoardBits getAnchored(const GameState& gs, const BoardBits& existing) {
+    int row = gs.board.nFulRowsTop - 1;
+    if (row < 0 || row >= BOARD_HEIGHT)
+        return {};
+    return (existing & BoardBits::rows(row, row + 1)).flood(existing, gs.board.even);
+}
+
+BoardBits getUnconnected(const GameState& gs, const BoardBits& removed) {
+    auto existing = getExisting(gs);
+    auto floating = existing & ~getAnchored(gs, existing);
+    return (removed.neighbours(gs.board.even) & floating).flood(floating, gs.board.even);
+}
+
+// Full shake along the matching streak around `pos`, fading with distance through
+// other tiles for up to `depth` steps
+void addShake(GameState& gs, const ThingPos& pos, const Thing& thing, int param, float shake, int depth) {
+    auto shakeNeighs = [&](const ThingPos& p, int curdepth, bool streak) {
+        for (auto& n : getNeighs(gs, p)) {
+            auto& tile = getTile(gs, n);
+            if (tile.exists)
+                tile.shake = std::max(tile.shake, (streak && checkMatch(tile.thing, thing, param)) ? shake : (shake / (curdepth + 2)));
+        }
+    };
+    auto& tile = getTile(gs, pos);
+    if (tile.exists) tile.shake = std::max(tile.shake, shake);
+    BoardBits streak = single(pos);
+    shakeNeighs(pos, 0, true);
+    floodFill(gs, streak, [&](const ThingPos& n, int) {
+        const auto& tile = getTile(gs, n);
+        if (!tile.exists || !checkMatch(tile.thing, thing, param))
+            return false;
+        streak.set(n.row, n.col);
+        shakeNeighs(n, 0, true);
+        return true;
+    });
+    floodFill(gs, streak, [&](const ThingPos& n, int curdepth) {
+        const auto& tile = getTile(gs, n);
+        if (curdepth >= depth || !tile.exists || checkMatch(tile.thing, thing, param))
+            return false;
+        shakeNeighs(n, curdepth, false);
+        return true;
+    });
+}
+
+void checkLines(GameState& gs) {
+    auto extraRows = countBotEmpRows(gs) - gs.board.nRowsGap;
+    if (extraRows > 0) {
+        shiftBoard(gs, extraRows);
+        generateRows(gs, extraRows);
+        gs.board.pos -= ROW_HEIGHT * extraRows;
+        updateBoardRect(gs);
+        gs.board.moveTime = gs.board.totalMoveTime = BOARD_MOVE_TIME_PER_LINE * extraRows;
+    }
+}
+
+void triggerBomb(GameState& gs, const ThingPos& pos) {
+    auto& thing = getTile(gs, pos).thing;
+    thing.triggered = true;
+    thing.triggerTime = getTime(gs);
+    gs.board.version++;
+    gs.bullet.exists = false;
+    emitSound(gs, SimSound::SIZZLE);
+    emitParticle(gs, gs.bullet.thing, gs.bullet.pos, {-gs.bullet.vel.x, -400.0f - 100.0f * RAND_FLOAT});
+}
+
+void checkDrop(GameState& gs, const ThingPos& pos, const Thing& thing, int minToDrop = 0) {
+    PROF_ZONE(CHECK_DROP);
+    int bestK = 0, bestScore = 0;
+    auto& todrops = gs.tmp.dropScratch.todrops;
+    auto& uncons = gs.tmp.dropScratch.uncons;
+    auto exists = getTile(gs, pos).exists;
+    int lim = (exists ? minToDrop : (minToDrop - 1));
+    for (int k = 0; k < gs.usr.n_params; ++k) {
+        todrops[k].clear();
+        uncons[k].clear();
+        collectMatching(gs, pos, thing, k, todrops[k]);
+        int count = todrops[k].count();
+        if (count >= lim) {
+            for (int i = 0; i < todrops[k].count(); ++i)
+                removeTile(gs, todrops[k].at(i));
+            getUnconnected(gs, todrops[k].index().bits).forEach([&](int row, int col) { uncons[k].acquire({row, col}); });
+            for (int i = 0; i < todrops[k].count(); ++i)
+                addTile(gs, todrops[k].at(i), getTile(gs, todrops[k].at(i)), true, true);
+            if (!exists && !todrops[k].has(pos)) todrops[k].acquire(pos);
+        }
+        int score = todrops[k].count() + uncons[k].count();
+        if (bestScore < score) {
+            bestScore = score;
+            bestK = k;
+        }
+    }
+    addShake(gs, pos, thing, bestK, SHAKE_TIME, SHAKE_DEPTH);
+    gs.board.todrop.assign(todrops[bestK]);
+    gs.board.uncon.assign(uncons[bestK]);
+}
+
+void explodeBomb(GameState& gs, const ThingPos& pos_);
+
+void doDrop(GameState& gs, int minToDrop = 0, bool shatter = true, Vector2 vel = Vector2Zero()) {
+    if (gs.board.todrop.count() >= minToDrop) {
+        for (int i = 0; i < gs.board.todrop.count(); ++i) {
+            auto& td = gs.board.todrop.at(i);
+            removeTile(gs, td);
+            auto pixpos = getPixByPos(gs, td);
+            if (shatter) {
+                emitAnimation(gs, SimAnim::SPLASH, pixpos, COMBO_COLORS[gs.board.lastDropCombo - 1]);
+                emitSound(gs, SimSound::SHATTER);
+                emitShatter(gs, getTile(gs, td).thing, pixpos);
+            } else {
+                emitParticle(gs, getTile(gs, td).thing, getPixByPos(gs, td), vel);
+            }
+            addScorePoints(gs, pixpos, COMBO_COLORS[gs.board.lastDropCombo - 1], gs.board.lastDropCombo);
+        }
+        for (int i = 0; i < gs.board.uncon.count(); ++i) {
+            auto& un = gs.board.uncon.at(i);
+            removeTile(gs, un);
+            auto pixpos = getPixByPos(gs, un);
+            emitParticle(gs, getTile(gs, un).thing, pixpos, Vector2Zero());
+            addScorePoints(gs, pixpos, COMBO_COLORS[gs.board.lastDropCombo - 1], gs.board.lastDropCombo);
+        }
+    }
+    gs.board.todrop.clear();
+    gs.board.uncon.clear();
+}
+
+void explodeBomb(GameState& gs, const ThingPos& pos) {
+    auto& thing = getTile(gs, pos).thing;
+    auto pixpos = getPixByPos(gs, pos);
+    emit(gs, {SimEventType::SHOCKWAVE, 0, {}, pixpos});
+    emitSound(gs, SimSound::EXPLOSION);
+    emitAnimation(gs, SimAnim::EXPLOSION, pixpos);
+    auto& tile = getTile(gs, pos);
+    removeTile(gs, pos);
+    for (auto& n : getNeighs(gs, pos)) {
+        auto ntile = getTile(gs, n);
+        if (ntile.exists) {
+            if (ntile.thing.bomb) {
+                triggerBomb(gs, n);
+            } else {
+                checkDrop(gs, n, ntile.thing);
+                if (gs.board.todrop.count())
+                    doDrop(gs);
+            }
+        }
+        for (auto& nn : getNeighs(gs, n)) {
+            auto nntile = getTile(gs, nn);
+            if (nntile.exists) {
+                if (nntile.thing.bomb) {
+                    //triggerBomb(gs, nntile.pos);
+                    explodeBomb(gs, nntile.pos);
+                } else {
+                    checkDrop(gs, nntile.pos, nntile.thing);
+                    doDrop(gs, 0, false, 300.0f * Vector2Normalize(getPixByPos(gs, nntile.pos) - pixpos));
+                }
+            }
+        }
+    }
+    addScorePoints(gs, pixpos, COMBO_COLORS[gs.board.lastDropCombo - 1], gs.board.lastDropCombo);
+}
+
+void checkBomb(GameState& gs, const ThingPos& pos) {
+    auto& tile = getTile(gs, pos);
+    if (tile.thing.triggered) {
+        tile.shake = std::clamp((getTime(gs) - tile.thing.triggerTime)/BOMB_TRIGGER_TIME, 0.0, 1.0);
+        if (getTime(gs) - tile.thing.triggerTime > BOMB_TRIGGER_TIME)
+            explodeBomb(gs, pos);
+    }
+}
+
+// The bullet touches a tile when either its centre or its leading edge is within hit distance
+bool bulletTouches(const GameState& gs, const Vector2& pos, const Vector2& lead, const Vector2& tpos) {
+    return Vector2DistanceSqr(tpos, pos) < BULLET_HIT_DIST_SQR || Vector2DistanceSqr(tpos, lead) < BULLET_HIT_DIST_SQR;
+}
+
+Vector2 bulletLead(const GameState& gs, const Vector2& pos, const Vector2& vel) {
+    return pos + Vector2Normalize(vel) * BULLET_RADIUS_H;
+}
+
+bool findHitBrute(const GameState& gs, ThingPos& hit) {
+    auto brect = getBoardRect(gs);
+    Vector2 lead = bulletLead(gs, gs.bullet.pos, gs.bullet.vel);
+    for (int i = 0; i < BOARD_HEIGHT; ++i) {
+        for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j) {
+            if (gs.board.things[i][j].exists && bulletTouches(gs, gs.bullet.pos, lead, getPixByPos(gs, brect, {i, j}))) {
+                hit = {i, j};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Anything within hit distance of the bullet is at most 2 radii from its centre, which
+// only the bullet's own cell and the ring around it can be. Of several touching tiles
+// the first in row-major order wins, same as a full scan.
+bool findHit(const GameState& gs, const Rectangle& brect, const Vector2& pos, const Vector2& vel, ThingPos& hit) {
+    Vector2 lead = bulletLead(gs, pos, vel);
+    auto cell = getPosByPix(gs, brect, pos);
+    bool found = false;
+    auto test = [&](const ThingPos& p) {
+        if (found && (p.row > hit.row || (p.row == hit.row && p.col > hit.col)))
+            return;
+        if (gs.board.things[p.row][p.col].exists && bulletTouches(gs, pos, lead, getPixByPos(gs, brect, p))) {
+            hit = p;
+            found = true;
+        }
+    };
+    test(cell);
+    for (auto& n : getNeighs(gs, cell))
+        test(n);
+    return found;
+}
+
+bool findHit(const GameState& gs, ThingPos& hit) {
+    return findHit(gs, getBoardRect(gs), gs.bullet.pos, gs.bullet.vel, hit);
+}
+
+// Earliest t in [0, maxT] at which p + d * t is within r of c, or -1. Assumes p starts outside.
+float circleContactTime(const Vector2& p, const Vector2& d, const Vector2& c, float r, float maxT) {
+    Vector2 m = p - c;
+    float b = Vector2DotProduct(m, d);
+    if (b >= 0)
+        return -1;
+    float a = Vector2DotProduct(d, d);
+    float disc = b * b - a * (Vector2DotProduct(m, m) - r * r);
+    if (disc < 0)
+        return -1;
+    float t = std::max((-b - sqrtf(disc)) / a, 0.0f);
+    return (t <= maxT) ? t : -1;
+}
+
+float findContactTime(const GameState& gs, const Vector2& pos, const Vector2& vel, float maxT, ThingPos& hit) {
+    auto brect = getBoardRect(gs);
+    if (findHit(gs, brect, pos, vel, hit))
+        return 0;
+    // Centre and leading edge both travel along the line from the centre now to the edge
+    // at maxT. A tile they can reach is within 2 radii of a sample taken at most one
+    // radius apart along it, i.e. in that sample's cell or around it.
+    Vector2 lead = bulletLead(gs, pos, vel);
+    Vector2 end = lead + vel * maxT;
+    int samples = 1 + (int)ceilf(Vector2Distance(pos, end) / TILE_RADIUS);
+    BoardBits seen;
+    float best = -1;
+    auto test = [&](const ThingPos& p) {
+        if (seen.test(p.row, p.col))
+            return;
+        seen.set(p.row, p.col);
+        if (!gs.board.things[p.row][p.col].exists)
+            return;
+        auto tpos = getPixByPos(gs, brect, p);
+        float r = TILE_RADIUS + BULLET_RADIUS_H;
+        float tl = circleContactTime(lead, vel, tpos, r, maxT);
+        float tc = circleContactTime(pos, vel, tpos, r, maxT);
+        float t = (tl < 0) ? tc : ((tc < 0) ? tl : std::min(tl, tc));
+        if (t >= 0 && (best < 0 || t < best || (t == best && (p.row < hit.row || (p.row == hit.row && p.col < hit.col))))) {
+            best = t;
+            hit = p;
+        }
+    };
+    for (int i = 0; i < samples; ++i) {
+        auto cell = getPosByPix(gs, brect, Vector2Lerp(pos, end, float(i) / std::max(samples - 1, 1)));
+        test(cell);
+        for (auto& n : getNeighs(gs, cell))
+            test(n);
+    }
+    return best;
+}
+
+float findWallTime(const GameState& gs, const Vector2& pos, const Vector2& vel) {
+    auto brect = getBoardRect(gs);
+    if (vel.x < 0)
+        return std::max((brect.x + BULLET_RADIUS_H - pos.x) / vel.x, 0.0f);
+    if (vel.x > 0)
+        return std::max((brect.x + brect.width - BULLET_RADIUS_H - pos.x) / vel.x, 0.0f);
+    return INFINITY;
+}
+
+// Empty cell next to the hit tile closest to where the bullet touched it
+ThingPos findSnapCell(GameState& gs, const ThingPos& hit, const Vector2& pos) {
+    auto res = getPosByPix(gs, pos);
+    float bestDist = getTile(gs, res).exists ? INFINITY : Vector2DistanceSqr(getPixByPos(gs, res), pos);
+    for (auto& n : getNeighs(gs, hit)) {
+        float dist = Vector2DistanceSqr(getPixByPos(gs, n), pos);
+        if (!getTile(gs, n).exists && dist < bestDist) {
+            bestDist = dist;
+            res = n;
+        }
+    }
+    return res;
+}
+
+void hitTile(GameState& gs, const ThingPos& hit) {
+    const auto& tile = getTile(gs, hit);
+    gs.bullet.lstEmp = findSnapCell(gs, hit, gs.bullet.pos);
+    emitSound(gs, SimSound::CLANG);
+    emitAnimation(gs, SimAnim::SPLASH, 0.5f * (getPixByPos(gs, hit) + getPixByPos(gs, gs.bullet.lstEmp)));
+    gs.board.lastDropCombo = gs.combo;
+    if (tile.thing.bomb) {
+        triggerBomb(gs, hit);
+        gs.combo = std::clamp(gs.combo + 1, 1, MAX_COMBO);
+        addScorePoints(gs, gs.bullet.pos, COMBO_COLORS[gs.board.lastDropCombo - 1], gs.board.lastDropCombo);
+    } else {
+        checkDrop(gs, gs.bullet.lstEmp, gs.bullet.thing, N_TO_DROP);
+        gs.bullet.rebouncing = true;
+        gs.bullet.rebounce = 0.0f;
+        gs.bullet.rebStart = gs.bullet.pos - Vector2{0, gs.board.pos};
+        gs.bullet.rebCp = (gs.bullet.pos - Vector2Normalize(gs.bullet.vel) * BULLET_REBOUNCE) - Vector2{0, gs.board.pos};
+        gs.bullet.rebEnd = (getPixByPos(gs, gs.bullet.lstEmp)) - Vector2{0, gs.board.pos};
+        gs.bullet.rebTime = getTime(gs);
+        if (gs.board.todrop.count() >= N_TO_DROP)
+            gs.combo = std::clamp(gs.combo + 1, 1, MAX_COMBO);
+        else
+            gs.combo = std::clamp(gs.combo - 1, 1, MAX_COMBO);
+    }
+}
+
+// Moves the bullet through the whole frame at once: straight legs between wall
+// bounces, stopping at the exact moment it first touches a tile
+void flyBullet(GameState& gs, float delta)
+{
+    if (gs.bullet.rebouncing) {
+        gs.bullet.pos = bezierQuad(gs.bullet.rebStart, gs.bullet.rebCp, gs.bullet.rebEnd, gs.bullet.rebounce) + Vector2{0, gs.board.pos};
+        float prog = (float)(getTime(gs) - gs.bullet.rebTime)/BULLET_REBOUNCE_TIME;
+        if (prog > 1.0f) {
+            gs.bullet.exists = false;
+            addTile(gs, gs.bullet.lstEmp, Tile{true, gs.bullet.lstEmp, gs.bullet.thing});
+            doDrop(gs, N_TO_DROP);
+            gs.bullet.rebouncing = false;
+        } else {
+            gs.bullet.rebounce = easeOutBounce(prog);
+        }
+        return;
+    }
+    for (int leg = 0; gs.bullet.exists && delta > 0 && leg < MAX_BULLET_LEGS; ++leg) {
+        float wall = findWallTime(gs, gs.bullet.pos, gs.bullet.vel);
+        float step = std::min(delta, wall);
+        ThingPos hit;
+        float contact = findContactTime(gs, gs.bullet.pos, gs.bullet.vel, step, hit);
+        if (contact >= 0) {
+            gs.bullet.pos += gs.bullet.vel * contact;
+            hitTile(gs, hit);
+            break;
+        }
+        gs.bullet.pos += gs.bullet.vel * step;
+        delta -= step;
+        if (step == wall) {
+            emitSound(gs, SimSound::CLANG);
+            emitAnimation(gs, SimAnim::SPLASH, gs.bullet.pos + Vector2{gs.bullet.vel.x/abs(gs.bullet.vel.x), 0});
+            gs.bullet.vel.x *= -1.0f;
+        }
+    }
+    if (gs.bullet.pos.y + TILE_RADIUS < 0)
+        gs.bullet.exists = false;
+}
+
+// Same legs as flyBullet, only all at once and on the board as it is now
+void traceAim(const GameState& gs, AimPath& path) {
+    Vector2 pos = muzzlePos(gs);
+    Vector2 vel = shotVel(gs);
+    path.count = 0;
+    path.hit = false;
+    path.points[path.count++] = pos;
+    for (int leg = 0; leg < MAX_BULLET_LEGS; ++leg) {
+        float wall = findWallTime(gs, pos, vel);
+        float top = (vel.y < 0) ? std::max((pos.y + TILE_RADIUS) / -vel.y, 0.0f) : INFINITY;
+        float step = std::min(wall, top);
+        if (step == INFINITY)
+            break;
+        float contact = findContactTime(gs, pos, vel, step, path.hitPos);
+        if (contact >= 0) {
+            path.points[path.count++] = pos + vel * contact;
+            path.hit = true;
+            break;
+        }
+        pos += vel * step;
+        path.points[path.count++] = pos;
+        if (step != wall)
+            break;
+        vel.x *= -1.0f;
+    }
+}
+
+void gameOver(GameState& gs) {
+    if (gs.gameOver)
+        return;
+    gs.gameOver = true;
+    gs.gameOverTime = getTime(gs);
+    gs.bullet.exists = false;
+    auto brec = getBoardRect(gs);
+    float h = gs.tmp.frame.height;
+    Vector2 gunPos = {brec.x + brec.width * 0.5f, h - TILE_RADIUS};
+    emitParticle(gs, gs.gun.armed, gunPos, Vector2{50.0f * RAND_FLOAT_SIGNED, -400.0f - 100.0f * RAND_FLOAT});
+    emitParticle(gs, gs.gun.next, {brec.x + brec.width - TILE_RADIUS, h - TILE_RADIUS}, Vector2{50.0f * RAND_FLOAT_SIGNED, -400.0f - 100.0f * RAND_FLOAT});
+    if (gs.gun.extraArmed)
+        emitParticle(gs, gs.gun.extra, {brec.x + TILE_RADIUS, h - TILE_RADIUS}, Vector2{50.0f * RAND_FLOAT_SIGNED, -400.0f - 100.0f * RAND_FLOAT});
+    if (!gs.alteredDifficulty && gs.score > gs.usr.bestScore) {
+        gs.usr.bestScore = gs.score;
+        emit(gs, {SimEventType::RECORD});
+    }
+    emitSound(gs, SimSound::FAIL);
+    emitSound(gs, SimSound::SHAKE);
+}
+
+void update(GameState& gs, const SimInput& in)
+{
+    PROF_ZONE(UPDATE);
+    if (gs.gameStartTime + GAME_START_TIME < getTime(gs)) {
+        auto delta = getFrameTime(gs);
+        auto brec = getBoardRect(gs);
+        if (in.aim) {
+            Vector2 gunPos = {(float)brec.x + brec.width * 0.5f, gs.tmp.frame.height - TILE_RADIUS};
+            gs.gun.dir = atan2(gunPos.y - in.aimPos.y, in.aimPos.x - gunPos.x) - PI * 0.5f;
+        } else if (in.turn != 0) {
+            gs.gun.dir += in.turn * gs.gun.speed * delta;
+            gs.gun.speed += GUN_ACC * delta;
+        } else {
+            gs.gun.speed = GUN_START_SPEED;
+        }
+        gs.gun.speed = std::clamp(gs.gun.speed, GUN_START_SPEED, GUN_FULL_SPEED);
+        gs.gun.dir = std::clamp(gs.gun.dir, -PI * 0.45f, PI * 0.45f);
+
+        flyBullet(gs, delta);
+    }
+}
+
+void updateOnce(GameState& gs, const SimInput& in)
+{
+    PROF_ZONE(UPDATE_ONCE);
+    if (gs.gameOver) {
+        for (int i = 0; i < BOARD_HEIGHT; ++i) {
+            for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j) {
+                const Tile& tile = gs.board.things[i][j];
+                if (tile.exists) {
+                    if ((getTime(gs) - gs.gameOverTime) > (GAME_OVER_TIME_PER_ROW * (BOARD_HEIGHT - 1 - i))) {
+                        gs.board.things[i][j].exists = false;
+                        gs.board.version++;
+                        Vector2 tpos = getPixByPos(gs, {i, j});
+                        if (tpos.y > 0) {
+                            emitSound(gs, SimSound::CLANG);
+                            emitParticle(gs, gs.board.things[i][j].thing, tpos, Vector2{50.0f * RAND_FLOAT_SIGNED, -400.0f - 100.0f * RAND_FLOAT});
+                        }
+                    }
+                }
+            }
+        }
+        if (getTime(gs) > gs.gameOverTime + GAME_OVER_TIMEOUT && in.restart)
+            resetGame(gs, gs.seed);
+    } else if (gs.gameStartTime + GAME_START_TIME < getTime(gs)) {
+        for (int i = 0; i < BOARD_HEIGHT; ++i) {
+            for (int j = 0; j < BOARD_WIDTH - ((i + gs.board.even) % 2); ++j) {
+                Tile& tile = gs.board.things[i][j];
+                if (tile.exists) {
+                    if (tile.shake < SHAKE_TIME || gs.board.todrop.count() < N_TO_DROP - 1)
+                        tile.shake = std::max(tile.shake - getFrameTime(gs), 0.0f);
+                    else
+                        tile.shake = std::min(tile.shake + getFrameTime(gs) * 2, MAX_SHAKE);
+                    Vector2 tpos = getPixByPos(gs, {i, j});
+                    if ((gs.tmp.frame.height - 2 * TILE_RADIUS) - (tpos.y + TILE_RADIUS) < 0)
+                        gameOver(gs);
+                    if (tile.thing.bomb)
+                        checkBomb(gs, {i, j});
+                }
+            }
+        }
+
+        if (in.editAdd || in.editRemove) {
+            auto mpos = getPosByPix(gs, in.editPos);
+            if (in.editAdd) {
+                addTile(gs, mpos, Tile{(mpos.col != (BOARD_WIDTH - 1)) || ((mpos.row + gs.board.even) % 2 == 0), {mpos.row, mpos.col},
+                                       {(unsigned char)getRandVal(gs, 0, COLORS.size() - 1), (unsigned char)getRandVal(gs, 0, COLORS.size() - 1), (unsigned char)getRandVal(gs, 0, COLORS.size() - 1)}});
+            } else {
+                removeTile(gs, mpos);
+            }
+        }
+
+        if (in.fire && !gs.bullet.exists)
+            shootAndRearm(gs);
+
+        if (in.swap)
+            swapExtra(gs);
+
+        if (gs.board.moveTime > 0 && gs.board.pos < 0) {
+            gs.board.pos = gs.board.pos * (1.0f - easeOutQuad(1.0f - gs.board.moveTime/gs.board.totalMoveTime));
+            gs.board.moveTime -= getFrameTime(gs);
+        }
+
+        if (in.cycleParams)
+            gs.usr.n_params = (gs.usr.n_params % 3) + 1;
+
+        if (gs.firstShotFired) {
+            if (gs.usr.velEnabled)
+                gs.board.pos += TILE_PIXEL * (gs.usr.accEnabled ? gs.board.speed : BOARD_CONST_SPEED) * getFrameTime(gs);
+            if (gs.usr.accEnabled)
+                gs.board.speed += BOARD_ACC * getFrameTime(gs);
+        }
+        updateBoardRect(gs);
+
+        if (in.easeDifficulty) {
+            if (gs.usr.accEnabled)
+                gs.usr.accEnabled = false;
+            else
+                gs.usr.velEnabled = false;
+        }
+
+        checkLines(gs);
+    }
+}
+
+void simStep(GameState& gs, const SimInput& in, const SimFrame& frame)
+{
+    setFrame(gs, frame);
+    gs.tmp.events.clear();
+
+    if (!gs.usr.velEnabled || !gs.usr.accEnabled || (gs.usr.n_params == 1))
+        gs.alteredDifficulty = true;
+    else if (!gs.firstShotFired) {
+        gs.alteredDifficulty = false;
+    }
+
+    if (gs.inputTimeoutTime == 0)
+        gs.inputTimeoutTime = getTime(gs);
+    if (getTime(gs) - gs.inputTimeoutTime > INPUT_TIMEOUT && getFrameTime(gs) < 1.0) {
+        update(gs, in);
+        updateOnce(gs, in);
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <span>
+
+#include "game.h"
+#include "util/fixed_queue.h"
+
+// Game rules without a window, audio device or input backend: everything the
+// platform would provide comes in through SimFrame/SimInput and everything it
+// should present goes out through gs.tmp.events.
+
+double getTime(const GameState& gs);
+float getFrameTime(const GameState& gs);
+int getRandVal(GameState& gs, int min, int max);
+
+float easeOutBounce(float x);
+float easeOutQuad(float t);
+float easeInQuad(float t);
+
+// Stores the frame and recomputes gs.tmp.layout from it
+void setFrame(GameState& gs, const SimFrame& frame);
+// Recomputes the board rect after the board or the game start time moved
+void updateBoardRect(GameState& gs);
+Rectangle getBoardRect(const GameState& gs);
+ThingPos getPosByPix(const GameState& gs, const Vector2& pix);
+ThingPos getPosByPix(const GameState& gs, const Rectangle& brec, const Vector2& pix);
+Vector2 getPixByPos(const GameState& gs, const ThingPos& pos);
+Vector2 getPixByPos(const GameState& gs, const Rectangle& brec, const ThingPos& pos);
+
+constexpr bool inBoard(bool even, int row, int col) {
+    return row >= 0 && row < BOARD_HEIGHT && col >= 0 && col < (((row + even) % 2) ? (BOARD_WIDTH - 1) : BOARD_WIDTH);
+}
+
+struct HexNeighs {
+    ThingPos pos[6];
+    int count;
+};
+
+// In-bounds neighbours of every cell for both row parities, in the order
+// east, west, up, down, up-diagonal, down-diagonal
+constexpr auto makeNeighTable() {
+    std::array<std::array<std::array<HexNeighs, BOARD_WIDTH>, BOARD_HEIGHT>, 2> res{};
+    for (int even = 0; even < 2; ++even) {
+        for (int row = 0; row < BOARD_HEIGHT; ++row) {
+            for (int col = 0; col < BOARD_WIDTH; ++col) {
+                int diag = ((row + even) % 2) ? (col + 1) : (col - 1);
+                ThingPos cand[6] = {{row, col + 1}, {row, col - 1}, {row - 1, col}, {row + 1, col}, {row - 1, diag}, {row + 1, diag}};
+                auto& n = res[even][row][col];
+                for (auto& c : cand)
+                    if (inBoard(even, c.row, c.col))
+                        n.pos[n.count++] = c;
+            }
+        }
+    }
+    return res;
+}
+
+inline constexpr auto NEIGH_TABLE = makeNeighTable();
+
+bool checkBounds(const GameState& gs, const ThingPos& pos);
+Tile& getTile(GameState& gs, const ThingPos& pos);
+
+inline std::span<const ThingPos> getNeighs(const GameState& gs, const ThingPos& pos) {
+    const auto& n = NEIGH_TABLE[gs.board.even][pos.row][pos.col];
+    return {n.pos, (size_t)n.count};
+}
+void addTile(GameState& gs, const ThingPos& pos, const Tile& tile, bool updateFullRows = true, bool makeExist = false);
+void removeTile(GameState& gs, const ThingPos& pos);
+
+// Tiles currently on the board
+BoardBits getExisting(const GameState& gs);
+// Tiles of `existing` still attached to the anchor row (nFulRowsTop - 1); everything else falls
+BoardBits getAnchored(const GameState& gs, const BoardBits& existing);
+// Clusters left hanging once the `removed` tiles are gone from the board
+BoardBits getUnconnected(const GameState& gs, const BoardBits& removed);
+
+struct FloodStep {
+    ThingPos pos;
+    int depth;
+};
+
+// Breadth-first walk from `seeds` (depth 0, always expanded). Each in-bounds cell
+// reached for the first time is offered once to `enter(pos, depth)`; when it
+// returns true the cell is expanded at that depth, otherwise it is left alone.
+// Every cell is queued at most once, so the board-sized queue never wraps.
+template <typename Enter>
+void floodFill(GameState& gs, const BoardBits& seeds, Enter&& enter) {
+    FixedQueue<BOARD_WIDTH * BOARD_HEIGHT, FloodStep> queue;
+    BoardBits seen = seeds;
+    seeds.forEach([&](int row, int col) { queue.push({{row, col}, 0}); });
+    while (!queue.empty()) {
+        auto step = queue.pop();
+        for (auto& n : getNeighs(gs, step.pos)) {
+            if (seen.test(n.row, n.col))
+                continue;
+            seen.set(n.row, n.col);
+            if (enter(n, step.depth + 1))
+                queue.push({n, step.depth + 1});
+        }
+    }
+}
+
+// First tile (row-major) the bullet is touching: findHit checks only the bullet's
+// cell and its neighbours, findHitBrute scans the board and is its reference
+bool findHit(const GameState& gs, ThingPos& hit);
+bool findHitBrute(const GameState& gs, ThingPos& hit);
+// Time within [0, maxT] when a bullet at `pos` moving at `vel` first touches a tile, or -1
+float findContactTime(const GameState& gs, const Vector2& pos, const Vector2& vel, float maxT, ThingPos& hit);
+// Time until the bullet reaches the side of the board it is heading to, 0 if already past it
+float findWallTime(const GameState& gs, const Vector2& pos, const Vector2& vel);
+
+// Where the gun fires from and the velocity a shot would leave it with now
+Vector2 muzzlePos(const GameState& gs);
+Vector2 shotVel(const GameState& gs);
+// Path of a shot fired now: the muzzle, every wall bounce and where it stops, on the
+// first tile it touches (path.hit) or past the top of the screen
+void traceAim(const GameState& gs, AimPath& path);
+
+// Gives `obj` its default value where it lies, with no temporary to copy from
+template <typename T>
+void resetInPlace(T& obj) {
+    std::destroy_at(&obj);
+    std::construct_at(&obj);
+}
+
+// New game from `seed`; usr, tmp and ga are left alone
+void resetGame(GameState& gs, unsigned int seed);
+void simStep(GameState& gs, const SimInput& in, const SimFrame& frame);
@@ -1,28 +1,80 @@
+#pragma once
+
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #ifdef GAME_BASE_DLL
 #include "../../../src/util/zpp_bits.h"
 #endif
 
-template <size_t CAP, typename T>
-class Arena 
+// What acquire does once an Arena holds CAP entries
+enum class ArenaOverflow {
+    DROP_NEWEST,        // keep what is there, the new entry is lost
+    OVERWRITE_OLDEST,   // the new entry replaces the first one acquired
+    GROW                // CAP is only the initial reservation
+};
+
+// Where an Arena keeps its CAP slots
+enum class ArenaStorage {
+    HEAP,               // a vector: cheap to move, every copy allocates
+    INLINE              // a std::array inside the Arena: no allocation, copies are a memcpy
+};
+
+// Membership index an Arena keeps in step with its entries; this one keeps nothing
+struct NoArenaIndex {
+    template <typename T> void add(const T&) {}
+    template <typename T> void remove(const T&) {}
+    void clear() {}
+};
+
+// Fixed-capacity pool with the live entries packed in [0, count()) in acquire order:
+// iterating never visits dead slots, and releasing moves entries, so indices are only
+// valid until then. With an INDEX other than NoArenaIndex, has() asks it instead of
+// scanning; such arenas must not hold the same entry twice.
+template <size_t CAP, typename T, ArenaOverflow POLICY = ArenaOverflow::DROP_NEWEST, typename INDEX = NoArenaIndex,
+          ArenaStorage STORAGE = ArenaStorage::HEAP>
+class Arena
 {
 #ifdef GAME_BASE_DLL
     friend zpp::bits::access;
-	using serialize = zpp::bits::members<2>;
+	using serialize = zpp::bits::members<4>;
 #endif
 
-    std::vector<T> _data;
+    static constexpr bool INLINE = (STORAGE == ArenaStorage::INLINE);
+    static_assert(!INLINE || POLICY != ArenaOverflow::GROW, "inline storage can't grow");
+    static_assert(!INLINE || std::is_trivially_copyable_v<T>, "inline arenas are relocated with plain copies");
+
+    std::conditional_t<INLINE, std::array<T, CAP>, std::vector<T>> _data;
     size_t _firstAvailableIdx;
+    size_t _head;
+    INDEX _index;
+
+    // Only OVERWRITE_OLDEST wraps around; elsewhere _head stays 0
+    size_t slot(size_t idx) const {
+        if constexpr (POLICY == ArenaOverflow::OVERWRITE_OLDEST) {
+            idx += _head;
+            return (idx >= CAP) ? idx - CAP : idx;
+        } else {
+            return idx;
+        }
+    }
 
 public:
-    
+
+    static constexpr size_t CAPACITY = CAP;
+    static constexpr ArenaOverflow OVERFLOW_POLICY = POLICY;
+    static constexpr size_t npos = size_t(-1);
+
     Arena() :
-        _firstAvailableIdx(0)
+        _firstAvailableIdx(0),
+        _head(0)
     {
-        _data.resize(CAP);
+        if constexpr (!INLINE)
+            _data.resize(CAP);
     }
 
     T* data() {
@@ -30,38 +82,91 @@ public:
     }
 
     size_t size() {
-        return CAP * sizeof(T);
+        return _data.size() * sizeof(T);
+    }
+
+    // Appends obj and returns its index, or npos if the policy dropped it
+    size_t acquire(const T& obj) {
+        if (_firstAvailableIdx == _data.size()) {
+            if constexpr (POLICY == ArenaOverflow::DROP_NEWEST) {
+                return npos;
+            } else if constexpr (POLICY == ArenaOverflow::OVERWRITE_OLDEST) {
+                _index.remove(_data[_head]);
+                _data[_head] = obj;
+                _index.add(obj);
+                _head = (_head + 1 == CAP) ? 0 : _head + 1;
+                return _firstAvailableIdx - 1;
+            } else {
+                if constexpr (!INLINE)
+                    _data.push_back(obj);
+                _index.add(obj);
+                return _firstAvailableIdx++;
+            }
+        }
+        _data[slot(_firstAvailableIdx)] = obj;
+        _index.add(obj);
+        return _firstAvailableIdx++;
+    }
+
+    // Releases every entry pred(entry) holds for, keeping the rest in order. pred may
+    // update the entry it is given, so one pass can both step and cull.
+    template <typename Pred>
+    size_t releaseIf(Pred&& pred) {
+        size_t kept = 0;
+        for (size_t i = 0; i < _firstAvailableIdx; ++i) {
+            auto& obj = _data[slot(i)];
+            if (pred(obj)) {
+                _index.remove(obj);
+            } else {
+                if (kept != i) _data[slot(kept)] = std::move(obj);
+                ++kept;
+            }
+        }
+        size_t released = _firstAvailableIdx - kept;
+        _firstAvailableIdx = kept;
+        return released;
     }
 
-    size_t acquire(const T& obj, size_t count = 1) {
-        _data[_firstAvailableIdx++] = obj;
-        return _firstAvailableIdx;
+    // Takes over other's live entries only, oldest first; the rest of the slots aren't touched
+    void assign(const Arena& other) {
+        clear();
+        if constexpr (!INLINE)
+            if (_data.size() < other.count()) _data.resize(other.count());
+        for (size_t i = 0; i < other.count(); ++i)
+            _data[i] = other.get(i);
+        _firstAvailableIdx = other.count();
+        _index = other._index;
     }
 
     T& at(size_t idx) {
-        return _data[idx];
-    }    
+        return _data[slot(idx)];
+    }
 
     const T& get(size_t idx) const {
-        return _data[idx];
+        return _data[slot(idx)];
     }
 
     size_t count() const {return _firstAvailableIdx;}
-    size_t capacity() {return CAP;}
+    size_t capacity() const {return _data.size();}
+    bool full() const {return _firstAvailableIdx == _data.size();}
 
     void clear() {
         _firstAvailableIdx = 0;
+        _head = 0;
+        _index.clear();
     }
 
-    bool has(const T& obj) {
-        bool found = false;
-        for (int i = 0; i < count(); ++i) {
-            if (_data[i].row == obj.row && _data[i].col == obj.col) {
-                found = true;
-                break;
-            }
-        }
-        return found;
+    const INDEX& index() const {return _index;}
+
+    bool has(const T& obj) const requires (!std::is_same_v<INDEX, NoArenaIndex>) {
+        return _index.contains(obj);
     }
 
-};
\ No newline at end of file
+};
+
+template <size_t CAP, typename T, ArenaOverflow POLICY = ArenaOverflow::DROP_NEWEST, typename INDEX = NoArenaIndex>
+using FixedArena = Arena<CAP, T, POLICY, INDEX, ArenaStorage::INLINE>;
+
+// Compile-time capacity of an Arena type, e.g. for static_asserts on worst cases
+template <typename A>
+inline constexpr size_t arena_capacity_v = std::remove_cvref_t<A>::CAPACITY;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// FIFO over a fixed ring of CAP slots; never allocates. Pushing into a full
+// queue overwrites the oldest entry, so size CAP for the worst case.
+template <size_t CAP, typename T>
+class FixedQueue
+{
+    std::array<T, CAP> _data;
+    size_t _head = 0;
+    size_t _count = 0;
+
+public:
+
+    void push(const T& obj) {
+        size_t idx = _head + _count;
+        _data[idx >= CAP ? idx - CAP : idx] = obj;
+        if (_count < CAP) ++_count;
+        else if (++_head == CAP) _head = 0;
+    }
+
+    T pop() {
+        T obj = _data[_head];
+        if (++_head == CAP) _head = 0;
+        --_count;
+        return obj;
+    }
+
+    bool empty() const {return _count == 0;}
+    size_t count() const {return _count;}
+    size_t capacity() const {return CAP;}
+
+    void clear() {
+        _head = _count = 0;
+    }
+
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <utility>
+
+#include "raylib.h"
+#include "rlgl.h"
+
+// A raylib Mesh whose CPU arrays are owned elsewhere (std::vectors next to it), so it
+// must not go through UnloadMesh. Move-only: its buffer ids have exactly one owner.
+struct GpuMesh : Mesh {
+    GpuMesh() : Mesh{} {}
+    GpuMesh(const GpuMesh&) = delete;
+    GpuMesh& operator=(const GpuMesh&) = delete;
+    GpuMesh(GpuMesh&& o) noexcept : Mesh(std::exchange<Mesh>(o, Mesh{})) {}
+    GpuMesh& operator=(GpuMesh&& o) noexcept {
+        std::swap<Mesh>(*this, o);
+        return *this;
+    }
+
+    // Frees the VAO and VBOs UploadMesh made, leaving the CPU arrays alone
+    void unload() {
+        if (vaoId)
+            rlUnloadVertexArray(vaoId);
+        if (vboId) {
+            for (int i = 0; i <= RL_DEFAULT_SHADER_ATTRIB_LOCATION_INDICES; ++i)
+                if (vboId[i])
+                    rlUnloadVertexBuffer(vboId[i]);
+            MemFree(vboId);
+        }
+        static_cast<Mesh&>(*this) = Mesh{};
+    }
+};
+
+// Holds a state's GPU objects inside a copyable GameState: a copy starts empty and an
+// assignment keeps what the target already has, so two states never share buffers
+template <typename T>
+struct GpuLocal : T {
+    GpuLocal() = default;
+    GpuLocal(const GpuLocal&) : T() {}
+    GpuLocal& operator=(const GpuLocal&) {return *this;}
+    GpuLocal(GpuLocal&&) = default;
+    GpuLocal& operator=(GpuLocal&&) = default;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// Bitset over a W x H hex board stored row-major (bit = row * W + col). Rows where
+// (row + even) is odd are "short": shifted right by half a tile and one cell narrower.
+template <int W, int H>
+class HexBits
+{
+    static constexpr int N = W * H;
+    static constexpr int WORDS = (N + 63) / 64;
+    static constexpr uint64_t TOP_MASK = (N % 64) ? ((uint64_t(1) << (N % 64)) - 1) : ~uint64_t(0);
+
+    std::array<uint64_t, WORDS> _words{};
+
+public:
+
+    constexpr HexBits() = default;
+
+    static constexpr int index(int row, int col) {
+        return row * W + col;
+    }
+
+    constexpr bool test(int row, int col) const {
+        int i = index(row, col);
+        return (_words[i >> 6] >> (i & 63)) & 1;
+    }
+
+    constexpr void set(int row, int col) {
+        int i = index(row, col);
+        _words[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    constexpr void clear(int row, int col) {
+        int i = index(row, col);
+        _words[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+
+    constexpr void clear() {
+        _words.fill(0);
+    }
+
+    constexpr int popcount() const {
+        int n = 0;
+        for (auto w : _words) n += std::popcount(w);
+        return n;
+    }
+
+    constexpr bool any() const {
+        for (auto w : _words) if (w) return true;
+        return false;
+    }
+
+    constexpr bool operator==(const HexBits&) const = default;
+
+    constexpr HexBits operator&(const HexBits& o) const { HexBits r; for (int i = 0; i < WORDS; ++i) r._words[i] = _words[i] & o._words[i]; return r; }
+    constexpr HexBits operator|(const HexBits& o) const { HexBits r; for (int i = 0; i < WORDS; ++i) r._words[i] = _words[i] | o._words[i]; return r; }
+    constexpr HexBits operator^(const HexBits& o) const { HexBits r; for (int i = 0; i < WORDS; ++i) r._words[i] = _words[i] ^ o._words[i]; return r; }
+    constexpr HexBits operator~() const { HexBits r; for (int i = 0; i < WORDS; ++i) r._words[i] = ~_words[i]; r._words[WORDS - 1] &= TOP_MASK; return r; }
+    constexpr HexBits& operator&=(const HexBits& o) { return *this = *this & o; }
+    constexpr HexBits& operator|=(const HexBits& o) { return *this = *this | o; }
+
+    // Moves every bit n places towards higher indices
+    constexpr HexBits shl(int n) const {
+        HexBits r;
+        int ws = n >> 6, bs = n & 63;
+        for (int i = WORDS - 1; i >= ws; --i) {
+            r._words[i] = _words[i - ws] << bs;
+            if (bs && i - ws - 1 >= 0) r._words[i] |= _words[i - ws - 1] >> (64 - bs);
+        }
+        r._words[WORDS - 1] &= TOP_MASK;
+        return r;
+    }
+
+    // Moves every bit n places towards lower indices
+    constexpr HexBits shr(int n) const {
+        HexBits r;
+        int ws = n >> 6, bs = n & 63;
+        for (int i = 0; i + ws < WORDS; ++i) {
+            r._words[i] = _words[i + ws] >> bs;
+            if (bs && i + ws + 1 < WORDS) r._words[i] |= _words[i + ws + 1] << (64 - bs);
+        }
+        return r;
+    }
+
+    static constexpr HexBits column(int col) {
+        HexBits r;
+        for (int row = 0; row < H; ++row) r.set(row, col);
+        return r;
+    }
+
+    static constexpr HexBits shortRows(bool even) {
+        HexBits r;
+        for (int row = 0; row < H; ++row)
+            if ((row + even) % 2)
+                for (int col = 0; col < W; ++col) r.set(row, col);
+        return r;
+    }
+
+    static constexpr HexBits rows(int from, int to) {
+        HexBits r;
+        for (int row = from; row < to; ++row)
+            for (int col = 0; col < W; ++col) r.set(row, col);
+        return r;
+    }
+
+    // Cells that exist on the board for the given row parity
+    static constexpr HexBits valid(bool even) {
+        return ~(shortRows(even) & column(W - 1));
+    }
+
+    // Every in-bounds cell adjacent to at least one set cell
+    HexBits neighbours(bool even) const {
+        static constexpr HexBits notFirst = ~column(0);
+        static constexpr HexBits notLast = ~column(W - 1);
+        static constexpr HexBits shortR[2] = {shortRows(false), shortRows(true)};
+        static constexpr HexBits validR[2] = {valid(false), valid(true)};
+        HexBits shortSrc = *this & shortR[even];
+        HexBits longSrc = *this & ~shortR[even];
+        HexBits r = (shl(1) & notFirst) | (shr(1) & notLast) | shl(W) | shr(W);
+        r |= (shortSrc.shr(W - 1) | shortSrc.shl(W + 1)) & notFirst;
+        r |= (longSrc.shr(W + 1) | longSrc.shl(W - 1)) & notLast;
+        return r & validR[even];
+    }
+
+    // Grows the set through adjacent cells of `through` until nothing new is reached
+    HexBits flood(const HexBits& through, bool even) const {
+        HexBits res = *this & through, prev;
+        do {
+            prev = res;
+            res |= res.neighbours(even) & through;
+        } while (!(res == prev));
+        return res;
+    }
+
+    // Calls f(row, col) for every set cell in index order
+    template <typename F>
+    constexpr void forEach(F&& f) const {
+        for (int i = 0; i < WORDS; ++i) {
+            for (uint64_t w = _words[i]; w; w &= w - 1) {
+                int idx = i * 64 + std::countr_zero(w);
+                f(idx / W, idx % W);
+            }
+        }
+    }
+
+};
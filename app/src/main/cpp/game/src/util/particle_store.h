@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "simd.h"
+
+// Falling particles kept as separate x/y/vx/vy arrays, so stepping them runs four
+// lanes at a time, with whatever the renderer needs (Look) in an array of its own.
+// Live particles stay packed in [0, count()) and in spawn order.
+template <size_t CAP, typename Look>
+class ParticleStore
+{
+    static constexpr size_t PADDED = (CAP + 3) & ~size_t(3);
+
+    std::vector<float> _x, _y, _vx, _vy;
+    std::vector<Look> _look;
+    size_t _count = 0;
+
+public:
+
+    static constexpr size_t npos = CAP;
+
+    ParticleStore() :
+        _x(PADDED), _y(PADDED), _vx(PADDED), _vy(PADDED), _look(CAP)
+    { }
+
+    // Returns the new particle's index, or npos (dropping it) when the store is full
+    size_t spawn(float x, float y, float vx, float vy, const Look& look) {
+        if (_count == CAP)
+            return npos;
+        _x[_count] = x;
+        _y[_count] = y;
+        _vx[_count] = vx;
+        _vy[_count] = vy;
+        _look[_count] = look;
+        return _count++;
+    }
+
+    // Moves everything by dt under gravity and drops particles falling below `bottom`
+    void step(float dt, float gravity, float bottom) {
+        F32x4 vdt = splat4(dt), dvy = splat4(gravity * dt), vbottom = splat4(bottom), zero = splat4(0.0f);
+        size_t kept = 0;
+        for (size_t i = 0; i < _count; i += 4) {
+            F32x4 vy = load4(&_vy[i]);
+            F32x4 x = add4(load4(&_x[i]), mul4(load4(&_vx[i]), vdt));
+            F32x4 y = add4(load4(&_y[i]), mul4(vy, vdt));
+            vy = add4(vy, dvy);
+            store4(&_x[i], x);
+            store4(&_y[i], y);
+            store4(&_vy[i], vy);
+            size_t lanes = std::min(_count - i, size_t(4));
+            int gone = greaterMask4(y, vbottom) & greaterMask4(vy, zero) & ((1 << lanes) - 1);
+            if (!gone && kept == i) {
+                kept += lanes;
+                continue;
+            }
+            for (size_t l = 0; l < lanes; ++l) {
+                if (gone & (1 << l))
+                    continue;
+                _x[kept] = _x[i + l];
+                _y[kept] = _y[i + l];
+                _vx[kept] = _vx[i + l];
+                _vy[kept] = _vy[i + l];
+                _look[kept] = _look[i + l];
+                ++kept;
+            }
+        }
+        _count = kept;
+    }
+
+    float x(size_t idx) const {return _x[idx];}
+    float y(size_t idx) const {return _y[idx];}
+    const Look& look(size_t idx) const {return _look[idx];}
+
+    size_t count() const {return _count;}
+    size_t capacity() const {return CAP;}
+
+    void clear() {
+        _count = 0;
+    }
+
+};
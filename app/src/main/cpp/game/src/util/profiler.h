@@ -0,0 +1,124 @@
+#pragma once
+
+// Scoped timing zones for the game loop. Built only with HEHEX_PROFILE (debug
+// builds, or -DHEHEX_PROFILE=ON); otherwise PROF_ZONE and PROF_END_FRAME expand
+// to nothing.
+
+#define PROF_TRACE_FRAMES 600
+
+#ifdef HEHEX_PROFILE
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+enum class ProfZone : uint8_t {
+    FRAME, INPUT, UPDATE, CHECK_DROP, UPDATE_ONCE, EFFECTS,
+    DRAW_BOARD, DRAW_GAME_OVER, DRAW_BOTTOM, DRAW_ANIMATIONS, DRAW_SCORE, DRAW_PARTICLES, DRAW_BULLET, DRAW_SETTINGS,
+    POST_PROCESS, END_DRAWING,
+    COUNT
+};
+
+inline constexpr const char* PROF_ZONE_NAMES[] = {
+    "frame", "input", "update", "checkDrop", "updateOnce", "effects",
+    "drawBoard", "drawGameOver", "drawBottom", "drawAnimations", "drawScore", "drawParticles", "drawBullet", "drawSettings",
+    "postProcess", "endDrawing"
+};
+
+// Milliseconds spent per zone, summed over each frame and kept for the last PROF_TRACE_FRAMES frames
+class Profiler
+{
+    static constexpr int ZONES = (int)ProfZone::COUNT;
+    using Frame = std::array<float, ZONES>;
+
+    std::array<Frame, PROF_TRACE_FRAMES> _trace{};
+    Frame _cur{};
+    size_t _frames = 0;
+
+public:
+
+    bool overlay = false;
+
+    void add(ProfZone zone, float ms) {
+        _cur[(int)zone] += ms;
+    }
+
+    void endFrame() {
+        _trace[_frames++ % PROF_TRACE_FRAMES] = _cur;
+        _cur.fill(0);
+    }
+
+    size_t count() const {return std::min(_frames, (size_t)PROF_TRACE_FRAMES);}
+
+    float last(ProfZone zone) const {
+        return _frames ? _trace[(_frames - 1) % PROF_TRACE_FRAMES][(int)zone] : 0.0f;
+    }
+
+    float average(ProfZone zone) const {
+        float sum = 0;
+        for (size_t i = 0; i < count(); ++i) sum += _trace[i][(int)zone];
+        return count() ? sum / count() : 0.0f;
+    }
+
+    float peak(ProfZone zone) const {
+        float res = 0;
+        for (size_t i = 0; i < count(); ++i) res = std::max(res, _trace[i][(int)zone]);
+        return res;
+    }
+
+    // One row per recorded frame, oldest first, one column per zone in ms
+    std::string csv() const {
+        std::string res = "n";
+        for (auto name : PROF_ZONE_NAMES) (res += ',') += name;
+        res += '\n';
+        char buf[32];
+        for (size_t i = _frames - count(); i < _frames; ++i) {
+            res += std::to_string(i);
+            for (float ms : _trace[i % PROF_TRACE_FRAMES]) {
+                snprintf(buf, sizeof(buf), ",%.4f", ms);
+                res += buf;
+            }
+            res += '\n';
+        }
+        return res;
+    }
+
+};
+
+inline Profiler& getProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+class ProfScope
+{
+    ProfZone _zone;
+    std::chrono::steady_clock::time_point _start;
+
+public:
+
+    ProfScope(ProfZone zone) :
+        _zone(zone),
+        _start(std::chrono::steady_clock::now())
+    { }
+
+    ~ProfScope() {
+        getProfiler().add(_zone, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - _start).count());
+    }
+
+};
+
+#define PROF_CONCAT_(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT_(a, b)
+#define PROF_ZONE(zone) ProfScope PROF_CONCAT(_profScope, __LINE__)(ProfZone::zone)
+#define PROF_END_FRAME() getProfiler().endFrame()
+
+#else
+
+#define PROF_ZONE(zone)
+#define PROF_END_FRAME()
+
+#endif
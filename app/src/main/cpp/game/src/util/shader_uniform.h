@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "raylib.h"
+
+// Uniform of TYPE (a SHADER_UNIFORM_* value) holding up to N values of T. Its location
+// is looked up once by locate(), and set() only uploads values that differ from the
+// last upload, so nothing else may set the same uniform.
+template <typename T, int TYPE, size_t N = 1>
+class ShaderUniform
+{
+    int _loc = -1;
+    mutable bool _uploaded = false;
+    mutable size_t _count = 0;
+    mutable std::array<T, N> _last;
+
+public:
+
+    void locate(const Shader& shader, const char* name) {
+        _loc = GetShaderLocation(shader, name);
+        _uploaded = false;
+    }
+
+    void set(const Shader& shader, const T& value) const {
+        set(shader, &value, 1);
+    }
+
+    void set(const Shader& shader, const T* values, size_t count) const {
+        count = std::min(count, N);
+        if (_loc < 0 || (_uploaded && count == _count && !memcmp(values, _last.data(), count * sizeof(T))))
+            return;
+        SetShaderValueV(shader, _loc, values, TYPE, (int)count);
+        memcpy(_last.data(), values, count * sizeof(T));
+        _count = count;
+        _uploaded = true;
+    }
+
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+// Four float lanes at a time: SSE2 on x86, NEON on ARM, plain loops anywhere else
+// (or with SIMD_SCALAR defined). Loads and stores don't need aligned pointers.
+
+#if !defined(SIMD_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define SIMD_SSE2
+    #include <emmintrin.h>
+#elif !defined(SIMD_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    #define SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+struct F32x4 {
+#if defined(SIMD_SSE2)
+    __m128 v;
+#elif defined(SIMD_NEON)
+    float32x4_t v;
+#else
+    float v[4];
+#endif
+};
+
+inline F32x4 load4(const float* p) {
+#if defined(SIMD_SSE2)
+    return {_mm_loadu_ps(p)};
+#elif defined(SIMD_NEON)
+    return {vld1q_f32(p)};
+#else
+    return {{p[0], p[1], p[2], p[3]}};
+#endif
+}
+
+inline void store4(float* p, F32x4 a) {
+#if defined(SIMD_SSE2)
+    _mm_storeu_ps(p, a.v);
+#elif defined(SIMD_NEON)
+    vst1q_f32(p, a.v);
+#else
+    for (int i = 0; i < 4; ++i) p[i] = a.v[i];
+#endif
+}
+
+inline F32x4 splat4(float x) {
+#if defined(SIMD_SSE2)
+    return {_mm_set1_ps(x)};
+#elif defined(SIMD_NEON)
+    return {vdupq_n_f32(x)};
+#else
+    return {{x, x, x, x}};
+#endif
+}
+
+inline F32x4 add4(F32x4 a, F32x4 b) {
+#if defined(SIMD_SSE2)
+    return {_mm_add_ps(a.v, b.v)};
+#elif defined(SIMD_NEON)
+    return {vaddq_f32(a.v, b.v)};
+#else
+    return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+#endif
+}
+
+inline F32x4 mul4(F32x4 a, F32x4 b) {
+#if defined(SIMD_SSE2)
+    return {_mm_mul_ps(a.v, b.v)};
+#elif defined(SIMD_NEON)
+    return {vmulq_f32(a.v, b.v)};
+#else
+    return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+#endif
+}
+
+// Bit i set where a[i] > b[i]
+inline int greaterMask4(F32x4 a, F32x4 b) {
+#if defined(SIMD_SSE2)
+    return _mm_movemask_ps(_mm_cmpgt_ps(a.v, b.v));
+#elif defined(SIMD_NEON)
+    static const uint32_t bits[4] = {1, 2, 4, 8};
+    uint32x4_t m = vandq_u32(vcgtq_f32(a.v, b.v), vld1q_u32(bits));
+    #if defined(__aarch64__)
+    return (int)vaddvq_u32(m);
+    #else
+    uint32x2_t s = vadd_u32(vget_low_u32(m), vget_high_u32(m));
+    return (int)vget_lane_u32(vpadd_u32(s, s), 0);
+    #endif
+#else
+    int res = 0;
+    for (int i = 0; i < 4; ++i) res |= (a.v[i] > b.v[i]) << i;
+    return res;
+#endif
+}
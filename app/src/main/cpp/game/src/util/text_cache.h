@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "raylib.h"
+#include "rlgl.h"
+
+// A string laid out the way DrawTextEx would place it: one quad per visible glyph,
+// relative to the text's top-left corner, with its UVs in the font atlas
+struct TextLayout {
+    struct Quad {
+        float x0, y0, x1, y1;
+        float u0, v0, u1, v1;
+    };
+    std::vector<Quad> quads;
+    Vector2 size;  // what MeasureTextEx gives
+};
+
+// Layouts of the last CAP distinct (text, size, colour, spacing) asked for, each built
+// once and then reused; a new one replaces the least recently used. get() is const and
+// the storage mutable, so drawing code holding a const GameState can fill it.
+template <size_t CAP>
+class TextCache
+{
+    struct Entry {
+        std::string text;
+        float size = 0;
+        float spacing = 0;
+        Color col = {};
+        uint64_t lastUse = 0;
+        TextLayout layout;
+    };
+
+    mutable std::vector<Entry> _entries;
+    mutable uint64_t _uses = 0;
+
+    static constexpr float LINE_SPACING = 2;  // raylib's default, nothing calls SetTextLineSpacing
+
+    static void layOut(const Font& font, std::string_view text, float size, float spacing, TextLayout& res) {
+        std::string str(text);
+        float scale = size / font.baseSize;
+        float pad = font.glyphPadding;
+        float offX = 0, offY = 0;
+        res.quads.clear();
+        for (size_t i = 0; i < str.size();) {
+            int bytes = 0;
+            int cp = GetCodepointNext(&str[i], &bytes);
+            i += bytes;
+            if (cp == '\n') {
+                offX = 0;
+                offY += size + LINE_SPACING;
+                continue;
+            }
+            int idx = GetGlyphIndex(font, cp);
+            const auto& rec = font.recs[idx];
+            const auto& glyph = font.glyphs[idx];
+            if (cp != ' ' && cp != '\t') {
+                float x0 = offX + (glyph.offsetX - pad) * scale, y0 = offY + (glyph.offsetY - pad) * scale;
+                res.quads.push_back({x0, y0, x0 + (rec.width + 2 * pad) * scale, y0 + (rec.height + 2 * pad) * scale,
+                                     (rec.x - pad) / font.texture.width, (rec.y - pad) / font.texture.height,
+                                     (rec.x + rec.width + pad) / font.texture.width, (rec.y + rec.height + pad) / font.texture.height});
+            }
+            offX += ((glyph.advanceX == 0) ? rec.width : glyph.advanceX) * scale + spacing;
+        }
+        res.size = MeasureTextEx(font, str.c_str(), size, spacing);
+    }
+
+public:
+
+    const TextLayout& get(const Font& font, std::string_view text, float size, Color col, float spacing) const {
+        ++_uses;
+        Entry* oldest = nullptr;
+        for (auto& e : _entries) {
+            if (e.size == size && e.spacing == spacing && e.col.r == col.r && e.col.g == col.g && e.col.b == col.b && e.col.a == col.a
+                && e.text == text) {
+                e.lastUse = _uses;
+                return e.layout;
+            }
+            if (!oldest || e.lastUse < oldest->lastUse)
+                oldest = &e;
+        }
+        Entry& e = (_entries.size() < CAP) ? _entries.emplace_back() : *oldest;
+        e.text = text;
+        e.size = size;
+        e.spacing = spacing;
+        e.col = col;
+        e.lastUse = _uses;
+        layOut(font, text, size, spacing, e.layout);
+        return e.layout;
+    }
+
+    size_t count() const {return _entries.size();}
+
+    void clear() {
+        _entries.clear();
+    }
+
+};
+
+// Emits every quad of `layout` at `pos` with the font texture bound once, as DrawTexturePro
+// would, so consecutive texts from one font share a draw call
+inline void drawTextLayout(const Font& font, const TextLayout& layout, Vector2 pos, Color col) {
+    if (layout.quads.empty())
+        return;
+    rlCheckRenderBatchLimit(4 * (int)layout.quads.size());
+    rlSetTexture(font.texture.id);
+    rlBegin(RL_QUADS);
+    rlColor4ub(col.r, col.g, col.b, col.a);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (const auto& q : layout.quads) {
+        rlTexCoord2f(q.u0, q.v0);
+        rlVertex2f(pos.x + q.x0, pos.y + q.y0);
+        rlTexCoord2f(q.u0, q.v1);
+        rlVertex2f(pos.x + q.x0, pos.y + q.y1);
+        rlTexCoord2f(q.u1, q.v1);
+        rlVertex2f(pos.x + q.x1, pos.y + q.y1);
+        rlTexCoord2f(q.u1, q.v0);
+        rlVertex2f(pos.x + q.x1, pos.y + q.y0);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
@@ -79,6 +79,10 @@ inline Vector2 operator/ (Vector2 v1, Vector2 v2) {
     return { v1.x / v2.x, v1.y / v2.y };
 }
 
+inline Vector2 bezierQuad(Vector2 start, Vector2 control, Vector2 end, float t) {
+    return (1.0f - t) * (1.0f - t) * start + 2.0f * (1.0f - t) * t * control + t * t * end;
+}
+
 inline Vector3 operator* (const Vector3& v, const float& coeff) {
     return { coeff * v.x, coeff * v.y, coeff * v.z };
 }
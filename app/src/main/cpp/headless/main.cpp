@@ -0,0 +1,415 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sim.h"
+#include "util/profiler.h"
+#include "util/vec_ops.h"
+
+// Command-line driver for the game rules: no window, GL or audio, only SimInput in and SimEvents out
+
+struct Options {
+    std::string cmd = "play";
+    int games = 100;
+    unsigned int seed = 1;
+    float dt = 1.0f / 60.0f;
+    long maxFrames = 50000000;
+    long iters = 100000;
+    float width = WINDOW_WIDTH;
+    float height = WINDOW_HEIGHT;
+    std::string trace;
+};
+
+void usage() {
+    printf("usage: hehex_headless [play] [options]\n"
+           "  play            bot plays full games with a fixed timestep (default)\n"
+           "  bench-anchored  cost of the floating cluster search on a full board\n"
+           "  diff-collide    check the bullet hit queries against a full scan and fine stepping\n"
+           "  bench-particles step a full ParticleStore against a one-at-a-time reference\n"
+           "  bench-reset     cost of starting a new game and of resolving a shot\n"
+           "options:\n"
+           "  --games N       number of finished games to play (default 100)\n"
+           "  --seed S        board and bot seed (default 1)\n"
+           "  --dt SEC        fixed timestep in seconds (default 1/60)\n"
+           "  --frames N      stop after N steps regardless of games played\n"
+           "  --size W H      virtual screen size (default %d %d)\n"
+           "  --iters N       benchmark iterations (default 100000)\n"
+           "  --trace FILE    write the last %d frames of profiler zones as CSV (profiling builds)\n", WINDOW_WIDTH, WINDOW_HEIGHT, PROF_TRACE_FRAMES);
+}
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    int i = 1;
+    if (i < argc && argv[i][0] != '-')
+        opt.cmd = argv[i++];
+    for (; i < argc; ++i) {
+        bool hasVal = i + 1 < argc;
+        if (!strcmp(argv[i], "--games") && hasVal) opt.games = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && hasVal) opt.seed = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--dt") && hasVal) opt.dt = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--frames") && hasVal) opt.maxFrames = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--iters") && hasVal) opt.iters = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--trace") && hasVal) opt.trace = argv[++i];
+        else if (!strcmp(argv[i], "--size") && i + 2 < argc) {
+            opt.width = atof(argv[++i]);
+            opt.height = atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Picks a random direction for every shot and restarts as soon as a finished game allows it
+SimInput botInput(const GameState& gs, float& aimDir) {
+    SimInput in;
+    auto brec = getBoardRect(gs);
+    Vector2 gunPos = {brec.x + brec.width * 0.5f, gs.tmp.frame.height - TILE_RADIUS};
+    if (!gs.bullet.exists) {
+        aimDir = (2.0f * RAND_FLOAT - 1.0f) * PI * 0.45f;
+        in.fire = true;
+    }
+    in.aim = true;
+    in.aimPos = {gunPos.x - sinf(aimDir) * brec.width, gunPos.y - cosf(aimDir) * brec.width};
+    in.restart = true;
+    return in;
+}
+
+bool writeTrace(const Options& opt) {
+    if (opt.trace.empty())
+        return true;
+#ifdef HEHEX_PROFILE
+    FILE* f = fopen(opt.trace.c_str(), "w");
+    if (!f) {
+        printf("cannot write %s\n", opt.trace.c_str());
+        return false;
+    }
+    fputs(getProfiler().csv().c_str(), f);
+    fclose(f);
+    return true;
+#else
+    printf("--trace needs a build with HEHEX_PROFILE (debug, or -DHEHEX_PROFILE=ON)\n");
+    return false;
+#endif
+}
+
+int play(const Options& opt) {
+    srand(opt.seed);
+    auto gs = std::make_unique<GameState>();
+    SimFrame frame = {0.0, opt.dt, opt.width, opt.height};
+    setFrame(*gs, frame);
+    resetGame(*gs, opt.seed);
+
+    int games = 0;
+    long frames = 0, events = 0, shots = 0, totalScore = 0;
+    int bestScore = 0;
+    float aimDir = 0;
+    double start = now();
+    while (games < opt.games && frames < opt.maxFrames) {
+        frame.time += frame.delta;
+        bool wasOver = gs->gameOver;
+        bool hadBullet = gs->bullet.exists;
+        simStep(*gs, botInput(*gs, aimDir), frame);
+        events += gs->tmp.events.count();
+        shots += (!hadBullet && gs->bullet.exists);
+        if (!wasOver && gs->gameOver) {
+            games++;
+            totalScore += gs->score;
+            bestScore = std::max(bestScore, gs->score);
+        }
+        frames++;
+        PROF_END_FRAME();
+    }
+    double elapsed = now() - start;
+
+    printf("games %d  frames %ld  shots %ld  events %ld\n", games, frames, shots, events);
+    printf("avg score %.1f  best score %d\n", games ? double(totalScore) / games : 0.0, bestScore);
+    printf("time %.3f s  frames/s %.0f  games/s %.1f  us/shot %.2f\n", elapsed, frames / elapsed, games / elapsed, shots ? elapsed * 1e6 / shots : 0.0);
+    return writeTrace(opt) ? 0 : 1;
+}
+
+// Every cell of all BOARD_HEIGHT rows filled, anchored at the top row
+std::unique_ptr<GameState> makeFullBoard(const Options& opt) {
+    auto gs = std::make_unique<GameState>();
+    setFrame(*gs, {0.0, opt.dt, opt.width, opt.height});
+    resetGame(*gs, opt.seed);
+    for (int i = 0; i < BOARD_HEIGHT; ++i)
+        for (int j = 0; j < BOARD_WIDTH - ((i + gs->board.even) % 2); ++j)
+            addTile(*gs, {i, j}, Tile{true, {i, j}, {(unsigned char)(rand() % 5), (unsigned char)(rand() % 5), (unsigned char)(rand() % 5)}}, false);
+    gs->board.nFulRowsTop = 1;
+    return gs;
+}
+
+int benchAnchored(const Options& opt) {
+    srand(opt.seed);
+    auto gs = makeFullBoard(opt);
+    long sink = 0;
+
+    double start = now();
+    for (long it = 0; it < opt.iters; ++it) {
+        auto existing = getExisting(*gs);
+        sink += getAnchored(*gs, existing).popcount();
+    }
+    double anchoredNs = (now() - start) * 1e9 / opt.iters;
+
+    // Worst case shot: a whole row is cleared and everything under it falls
+    std::vector<int> cuts(opt.iters);
+    for (auto& c : cuts) c = 1 + rand() % (BOARD_HEIGHT - 2);
+    long fallen = 0;
+    start = now();
+    for (long it = 0; it < opt.iters; ++it) {
+        int row = cuts[it];
+        BoardBits removed;
+        for (int j = 0; j < BOARD_WIDTH - ((row + gs->board.even) % 2); ++j) {
+            gs->board.things[row][j].exists = false;
+            removed.set(row, j);
+        }
+        fallen += getUnconnected(*gs, removed).popcount();
+        removed.forEach([&](int i, int j) { gs->board.things[i][j].exists = true; });
+    }
+    double shotNs = (now() - start) * 1e9 / opt.iters;
+
+    printf("full board: %d tiles, %d rows\n", getExisting(*gs).popcount(), BOARD_HEIGHT);
+    printf("getAnchored     %8.1f ns/call\n", anchoredNs);
+    printf("getUnconnected  %8.1f ns/shot  (avg %.1f tiles falling)\n", shotNs, double(fallen) / opt.iters);
+    return sink == -1;
+}
+
+bool sameHit(const GameState& gs, long& mismatches) {
+    ThingPos fast = {-1, -1}, brute = {-1, -1};
+    bool hitFast = findHit(gs, fast), hitBrute = findHitBrute(gs, brute);
+    if (hitFast == hitBrute && (!hitFast || (fast.row == brute.row && fast.col == brute.col)))
+        return true;
+    if (mismatches++ < 10)
+        printf("mismatch at bullet (%.2f, %.2f): local %d (%d, %d)  scan %d (%d, %d)\n", gs.bullet.pos.x, gs.bullet.pos.y,
+            hitFast, fast.row, fast.col, hitBrute, brute.row, brute.col);
+    return false;
+}
+
+// Swept contact over `maxT` against the bullet stepped in fine increments: the first
+// step that touches must bracket the swept contact time. Walls are ignored.
+bool checkSweep(GameState& gs, float maxT, long& sweepOnly, long& mismatches) {
+    const int STEPS = 256;
+    ThingPos hit;
+    if (findHit(gs, hit))
+        return false;
+    Vector2 start = gs.bullet.pos;
+    float t = findContactTime(gs, start, gs.bullet.vel, maxT, hit);
+    int k = 1;
+    for (; k <= STEPS; ++k) {
+        gs.bullet.pos = start + gs.bullet.vel * (maxT * k / STEPS);
+        if (findHit(gs, hit))
+            break;
+    }
+    gs.bullet.pos = start;
+    if (k > STEPS) {
+        sweepOnly += (t >= 0);
+        return true;
+    }
+    float eps = 1e-5f;
+    if (t >= maxT * (k - 1) / STEPS - eps && t <= maxT * k / STEPS + eps)
+        return true;
+    if (mismatches++ < 10)
+        printf("sweep mismatch at bullet (%.2f, %.2f): swept t %.6f  stepped t %.6f\n", start.x, start.y, t, maxT * k / STEPS);
+    return true;
+}
+
+// Random boards and bullets, then every in-flight frame of bot games
+int diffCollide(const Options& opt) {
+    srand(opt.seed);
+    auto state = std::make_unique<GameState>();
+    auto& gs = *state;
+    setFrame(gs, {0.0, opt.dt, opt.width, opt.height});
+    resetGame(gs, opt.seed);
+    long checks = 0, hits = 0, mismatches = 0;
+    long sweepChecks = 0, sweepOnly = 0, sweepMismatches = 0;
+
+    double fastTime = 0, bruteTime = 0;
+    for (long it = 0; it < opt.iters; ++it) {
+        float density = RAND_FLOAT;
+        gs.board.even = rand() % 2;
+        gs.board.pos = (RAND_FLOAT - 0.5f) * 4.0f * ROW_HEIGHT;
+        gs.tmp.frame.time = gs.gameStartTime + RAND_FLOAT * GAME_START_TIME * 1.5f;
+        updateBoardRect(gs);
+        for (int i = 0; i < BOARD_HEIGHT; ++i)
+            for (int j = 0; j < BOARD_WIDTH; ++j)
+                gs.board.things[i][j].exists = inBoard(gs.board.even, i, j) && RAND_FLOAT < density;
+        auto brec = getBoardRect(gs);
+        float margin = 2.0f * TILE_RADIUS;
+        gs.bullet.pos = {brec.x - margin + RAND_FLOAT * (brec.width + 2 * margin), brec.y - margin + RAND_FLOAT * (brec.height + 2 * margin)};
+        float dir = RAND_FLOAT * 2.0f * PI;
+        gs.bullet.vel = Vector2Scale({cosf(dir), sinf(dir)}, BULLET_SPEED);
+        ThingPos hit;
+        double start = now();
+        hits += findHit(gs, hit);
+        fastTime += now() - start;
+        start = now();
+        findHitBrute(gs, hit);
+        bruteTime += now() - start;
+        sameHit(gs, mismatches);
+        checks++;
+        if (it % 10 == 0)
+            sweepChecks += checkSweep(gs, opt.dt * 4, sweepOnly, sweepMismatches);
+    }
+
+    setFrame(gs, {0.0, opt.dt, opt.width, opt.height});
+    resetGame(gs, opt.seed);
+    SimFrame frame = gs.tmp.frame;
+    int games = 0;
+    float aimDir = 0;
+    for (long frames = 0; games < opt.games && frames < opt.maxFrames; ++frames) {
+        frame.time += frame.delta;
+        bool wasOver = gs.gameOver;
+        simStep(gs, botInput(gs, aimDir), frame);
+        if (gs.bullet.exists && !gs.bullet.rebouncing) {
+            sameHit(gs, mismatches);
+            checks++;
+        }
+        games += (!wasOver && gs.gameOver);
+    }
+
+    printf("checks %ld  random hits %ld  mismatches %ld\n", checks, hits, mismatches);
+    printf("local %.1f ns/query  scan %.1f ns/query\n", fastTime * 1e9 / opt.iters, bruteTime * 1e9 / opt.iters);
+    printf("sweeps %ld  grazes seen only by sweep %ld  sweep mismatches %ld\n", sweepChecks, sweepOnly, sweepMismatches);
+    return mismatches != 0 || sweepMismatches != 0;
+}
+
+struct RefParticle {
+    Vector2 pos, vel;
+    int id;
+};
+
+// Keeps the store full of falling particles for `iters` frames, checking it against a plain loop over structs
+int benchParticles(const Options& opt) {
+    const float gravity = GRAVITY, bottom = opt.height;
+    srand(opt.seed);
+    auto store = std::make_unique<ParticleStore<MAX_FALLING_PARTICLES, int>>();
+    std::vector<RefParticle> ref;
+    int nextId = 0;
+    long frames = std::max(1L, opt.iters / 100), mismatches = 0, stepped = 0;
+    double storeTime = 0, refTime = 0;
+    for (long f = 0; f < frames; ++f) {
+        while (store->count() < store->capacity()) {
+            Vector2 pos = {RAND_FLOAT * opt.width, RAND_FLOAT * opt.height};
+            Vector2 vel = {400.0f * RAND_FLOAT_SIGNED, -400.0f * RAND_FLOAT};
+            store->spawn(pos.x, pos.y, vel.x, vel.y, nextId);
+            ref.push_back({pos, vel, nextId++});
+        }
+        stepped += store->count();
+        double start = now();
+        store->step(opt.dt, gravity, bottom);
+        storeTime += now() - start;
+        start = now();
+        size_t kept = 0;
+        for (auto& p : ref) {
+            p.pos = p.pos + p.vel * opt.dt;
+            p.vel.y += gravity * opt.dt;
+            if (!(p.pos.y > bottom && p.vel.y > 0))
+                ref[kept++] = p;
+        }
+        ref.resize(kept);
+        refTime += now() - start;
+        // Both keep spawn order. Rounding may put a particle right at the bottom on
+        // different sides in the two, so one of them drops it a frame earlier.
+        size_t i = 0, j = 0;
+        bool same = true;
+        while (same && (i < store->count() || j < ref.size())) {
+            if (i < store->count() && j < ref.size() && store->look(i) == ref[j].id) {
+                same = fabsf(store->x(i) - ref[j].pos.x) < 1e-2f && fabsf(store->y(i) - ref[j].pos.y) < 1e-2f;
+                ++i, ++j;
+            } else if (j < ref.size() && (i == store->count() || ref[j].id < store->look(i))) {
+                same = fabsf(ref[j].pos.y - bottom) < 1e-2f;
+                ref.erase(ref.begin() + j);
+            } else {
+                same = fabsf(store->y(i) - bottom) < 1e-2f;
+                ++i;
+            }
+        }
+        if (!same && mismatches++ < 10)
+            printf("mismatch after frame %ld: %zu particles in store, %zu in reference\n", f, store->count(), ref.size());
+    }
+    printf("frames %ld  particles stepped %ld  mismatches %ld\n", frames, stepped, mismatches);
+    printf("store %.2f ns/particle  reference %.2f ns/particle\n", storeTime * 1e9 / stepped, refTime * 1e9 / stepped);
+    return mismatches != 0;
+}
+
+// How resetGame used to start over: a whole GameState built aside and copied around usr/tmp/ga
+void copyReset(GameState& gs, unsigned int seed) {
+    auto usr = gs.usr;
+    auto tmp = gs.tmp;
+    auto ga = gs.ga;
+    gs = GameState{};
+    gs.usr = usr;
+    gs.tmp = tmp;
+    gs.ga = ga;
+    resetGame(gs, seed);
+}
+
+// Times resetGame alone and with the old copies in front, then the frames spent on shots
+// (from the trigger until the bullet has landed and its drop resolved) while the bot plays
+int benchReset(const Options& opt) {
+    srand(opt.seed);
+    auto state = std::make_unique<GameState>();
+    auto& gs = *state;
+    SimFrame frame = {0.0, opt.dt, opt.width, opt.height};
+    setFrame(gs, frame);
+
+    double start = now();
+    for (long i = 0; i < opt.iters; ++i)
+        resetGame(gs, opt.seed + i);
+    double inPlace = now() - start;
+    start = now();
+    for (long i = 0; i < opt.iters; ++i)
+        copyReset(gs, opt.seed + i);
+    double copied = now() - start;
+
+    resetGame(gs, opt.seed);
+    long shots = 0, shotFrames = 0, target = std::max(1L, opt.iters / 10);
+    double shotTime = 0;
+    float aimDir = 0;
+    while (shots < target) {
+        frame.time += frame.delta;
+        bool hadBullet = gs.bullet.exists;
+        auto in = botInput(gs, aimDir);
+        start = now();
+        simStep(gs, in, frame);
+        double elapsed = now() - start;
+        if (hadBullet || gs.bullet.exists) {
+            shotTime += elapsed;
+            shotFrames++;
+        }
+        shots += (!hadBullet && gs.bullet.exists);
+    }
+
+    printf("resets %ld  in place %.3f us  with full copy %.3f us\n", opt.iters, inPlace * 1e6 / opt.iters, copied * 1e6 / opt.iters);
+    printf("shots %ld  frames %ld  %.3f us/shot  %.3f us/frame\n", shots, shotFrames, shotTime * 1e6 / shots, shotTime * 1e6 / shotFrames);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 1;
+    }
+    if (opt.cmd == "play")
+        return play(opt);
+    if (opt.cmd == "bench-anchored")
+        return benchAnchored(opt);
+    if (opt.cmd == "diff-collide")
+        return diffCollide(opt);
+    if (opt.cmd == "bench-particles")
+        return benchParticles(opt);
+    if (opt.cmd == "bench-reset")
+        return benchReset(opt);
+    usage();
+    return 1;
+}
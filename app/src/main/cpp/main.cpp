@@ -6,7 +6,7 @@ int main(void)
 {
     SetConfigFlags(FLAG_MSAA_4X_HINT);
     InitWindow(0, 0, "raylib [core] example - basic window");
-    SetTargetFPS(60);
+    SetTargetFPS(TARGET_FPS);
 
     GameAssets ga;
     GameState gs;
@@ -17,6 +17,7 @@ int main(void)
         updateAndDraw(gs);
     }
 
+    deinit(gs);
     CloseWindow();        // Close window and OpenGL context
 
     return 0;